@@ -42,7 +42,8 @@ public class BlueprintMessage : ModuleRules
 			"Core",
 			"CoreUObject",
 			"Engine",
-			"DeveloperSettings"
+			"DeveloperSettings",
+			"TraceLog"
 		});
 
 		if (Target.bBuildEditor)
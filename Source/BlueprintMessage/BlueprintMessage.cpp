@@ -2,17 +2,43 @@
 
 #include "BlueprintMessage.h"
 
+#include "BlueprintMessagePool.h"
+#include "BlueprintMessageQueue.h"
+#include "BlueprintMessageSuppressor.h"
+#include "BlueprintMessageCategoryGate.h"
 #include "BlueprintMessageSettings.h"
+#include "BlueprintMessageSink.h"
+#include "BlueprintMessageTrace.h"
+#include "BlueprintMessageStats.h"
 #include "BlueprintMessageTokenFactory.h"
+#include "BlueprintMessageTextRenderer.h"
 #include "UObject/Package.h"
 #include "Kismet/KismetSystemLibrary.h"
+#include "Async/Async.h"
 #include "Logging/MessageLog.h"
+#include "Misc/ScopeRWLock.h"
 
 UBlueprintMessage* UBlueprintMessage::CreateMessageImpl()
 {
+	SCOPE_CYCLE_COUNTER(STAT_BlueprintMessage_Create);
+
 	const UBlueprintMessageSettings* Settings = UBlueprintMessageSettings::Get();
 
-	UBlueprintMessage* Object = NewObject<UBlueprintMessage>(GetTransientPackage(), UBlueprintMessage::StaticClass(), NAME_None, RF_Transient|RF_DuplicateTransient);
+	UBlueprintMessage* Object = nullptr;
+	// pool is game thread only
+	if (Settings->bEnableMessagePool && IsInGameThread())
+	{
+		if (FBlueprintMessagePool* Pool = FBlueprintMessagePool::Get())
+		{
+			Object = Pool->Acquire();
+		}
+	}
+
+	if (!Object)
+	{
+		Object = NewObject<UBlueprintMessage>(GetTransientPackage(), UBlueprintMessage::StaticClass(), NAME_None, RF_Transient|RF_DuplicateTransient);
+	}
+
 	Object->Category = Settings->GetDefaultCategory();
 	Object->bSuppressLoggingToOutputLog = Settings->bDefaultSuppressLoggingToOutputLog;
 	Object->bAutoDestroy = Settings->bDefaultAutoDestroy;
@@ -20,11 +46,12 @@ UBlueprintMessage* UBlueprintMessage::CreateMessageImpl()
 	return Object;
 }
 
-UBlueprintMessage* UBlueprintMessage::CreateBlueprintMessage(FName LogCategory, EBlueprintMessageSeverity Severity)
+UBlueprintMessage* UBlueprintMessage::CreateBlueprintMessage(FName LogCategory, EBlueprintMessageSeverity Severity, int32 InCallSiteId)
 {
 	UBlueprintMessage* Object = CreateMessageImpl();
 	Object->Category = LogCategory;
 	Object->Severity = Severity;
+	Object->CallSiteId = static_cast<uint32>(InCallSiteId);
 	return Object;
 }
 
@@ -43,6 +70,7 @@ UBlueprintMessage* UBlueprintMessage::CreateSimpleBlueprintMessage(FName LogCate
 
 UBlueprintMessage::UBlueprintMessage()
 {
+	INC_DWORD_STAT(STAT_BlueprintMessage_NumLive);
 #if UE_BUILD_DEBUG
 	UE_LOG(LogBlueprintMessage, Verbose, TEXT("Construct UBlueprintMessage at %p"), this);
 #endif
@@ -50,6 +78,7 @@ UBlueprintMessage::UBlueprintMessage()
 
 UBlueprintMessage::~UBlueprintMessage()
 {
+	DEC_DWORD_STAT(STAT_BlueprintMessage_NumLive);
 #if UE_BUILD_DEBUG
 	UE_LOG(LogBlueprintMessage, Verbose, TEXT("Destroy UBlueprintMessage at %p"), this);
 #endif
@@ -57,11 +86,22 @@ UBlueprintMessage::~UBlueprintMessage()
 
 UBlueprintMessage* UBlueprintMessage::Duplicate()
 {
+	if (!CheckNotReleased())
+	{
+		return nullptr;
+	}
+
 	UBlueprintMessage* Object = CreateMessageImpl();
 	Object->Category = Category;
 	Object->Severity = Severity;
 	Object->InitialMessage = InitialMessage;
+	Object->CallSiteId = CallSiteId;
+	// token storage with slot index, built message and printed line are shared until either message changes
 	Object->Tokens = Tokens;
+	Object->InvalidateBuiltMessage();
+	Object->CachedMessage = CachedMessage;
+	Object->CachedCategory = CachedCategory;
+	Object->CachedPrintLine = CachedPrintLine;
 	Object->bSuppressLoggingToOutputLog = bSuppressLoggingToOutputLog;
 	Object->bAutoDestroy = bAutoDestroy;
 	return Object;
@@ -69,79 +109,146 @@ UBlueprintMessage* UBlueprintMessage::Duplicate()
 
 void UBlueprintMessage::Destroy()
 {
-	Tokens.Empty();
+	DestroyImpl(true);
+}
+
+void UBlueprintMessage::DestroyImpl(bool bAllowPool)
+{
+	// pool and garbage flags are game thread only, message shown from worker is destroyed on game thread
+	if (!IsInGameThread())
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<UBlueprintMessage>(this), bAllowPool]()
+		{
+			if (UBlueprintMessage* Message = WeakThis.Get())
+			{
+				Message->DestroyImpl(bAllowPool);
+			}
+		});
+		return;
+	}
+
+	if (bInPool)
+	{
+		// already recycled, treat repeated destroy as handled
+		return;
+	}
+
+	if (bAllowPool && UBlueprintMessageSettings::Get()->bEnableMessagePool)
+	{
+		FBlueprintMessagePool* Pool = FBlueprintMessagePool::Get();
+		if (Pool && Pool->Release(this))
+		{
+			return;
+		}
+	}
+
+	Tokens.Reset();
+	InvalidateBuiltMessage();
 	MarkAsGarbage();
 }
 
+bool UBlueprintMessage::CheckNotReleased() const
+{
+	if (bInPool)
+	{
+		UE_LOG(LogBlueprintMessage, Warning, TEXT("Attempt to use message %s after it was destroyed"), *GetName());
+		return false;
+	}
+	return true;
+}
+
+void UBlueprintMessage::ResetMessage()
+{
+	Category = TEXT("BlueprintLog");
+	Severity = EBlueprintMessageSeverity::Info;
+	InitialMessage = FText::GetEmpty();
+	CallSiteId = 0;
+	Tokens.Reset();
+	InvalidateBuiltMessage();
+	bSuppressLoggingToOutputLog = false;
+	bAutoDestroy = false;
+}
+
+void UBlueprintMessage::InvalidateBuiltMessage()
+{
+	CachedMessage.Reset();
+	CachedPrintLine.Reset();
+}
+
 UBlueprintMessage* UBlueprintMessage::AddToken(const FBlueprintMessageToken& Token, FName Slot)
 {
+	if (!CheckNotReleased())
+	{
+		return this;
+	}
+
 	// No slot parameter set - add a new token
 	if (Slot.IsNone())
 	{
 		Tokens.Add(Token);
 	}
-	else
+	// Set matching slots with new token
+	else if (!Tokens.FillSlot(Slot, Token))
 	{
-		// Find matching slots and set it with new token
-		bool bAnythingSet = false;
-		for (FBlueprintMessageToken& Item : Tokens)
-		{
-			if (Item.Name == Slot)
-			{
-				Item.Instance = Token.Instance;
-				bAnythingSet = true;
-			}
-		}
-
 		// This is a new token with slot name (compatibility with existing uses)
-		if (!bAnythingSet)
-		{
-			Tokens.Add_GetRef(Token).Name = Slot;
-		}
+		FBlueprintMessageToken NamedToken(Token);
+		NamedToken.Name = Slot;
+		Tokens.Add(NamedToken);
 	}
 
+	InvalidateBuiltMessage();
 	return this;
 }
 
+UBlueprintMessage* UBlueprintMessage::AddTokenAtCallSite(const FBlueprintMessageToken& Token, FName Slot, int32 InCallSiteId)
+{
+	// message created by Create Message node keeps its origin, others take first node that adds to them
+	if (CallSiteId == 0 && !bInPool)
+	{
+		CallSiteId = static_cast<uint32>(InCallSiteId);
+	}
+	return AddToken(Token, Slot);
+}
+
 UBlueprintMessage* UBlueprintMessage::AddTokens(const TArray<FBlueprintMessageToken>& InTokens)
 {
-	Tokens.Reserve(Tokens.Num() + InTokens.Num());
-	for (const FBlueprintMessageToken& Token : InTokens)
+	if (InTokens.IsEmpty() || !CheckNotReleased())
 	{
-		Tokens.Add(Token);
+		return this;
 	}
+
+	// single bulk append, storage shared with duplicates is cloned at most once
+	Tokens.Append(InTokens);
+	InvalidateBuiltMessage();
 	return this;
 }
 
 UBlueprintMessage* UBlueprintMessage::AddNamedSlot(FName Name)
 {
+	if (!CheckNotReleased())
+	{
+		return this;
+	}
+
 	Tokens.Add(FBlueprintMessageToken(Name));
+	InvalidateBuiltMessage();
 	return this;
 }
 
 UBlueprintMessage* UBlueprintMessage::RemoveNamedSlot(FName Name)
 {
-	for(auto It = Tokens.CreateIterator(); It; ++It)
+	if (CheckNotReleased() && Tokens.RemoveSlot(Name) > 0)
 	{
-		if (It->Name == Name)
-		{
-			It.RemoveCurrent();
-		}
+		InvalidateBuiltMessage();
 	}
 	return this;
 }
 
 UBlueprintMessage* UBlueprintMessage::FillNamedSlot(FName Name, const FBlueprintMessageToken& Token)
 {
-	if (!Name.IsNone())
+	if (!Name.IsNone() && CheckNotReleased() && Tokens.FillSlot(Name, Token))
 	{
-		for (FBlueprintMessageToken& Item : Tokens)
-		{
-			if (Item.Name == Name)
-			{
-				Item.Instance = Token.Instance;
-			}
-		}
+		InvalidateBuiltMessage();
 	}
 
 	return this;
@@ -149,88 +256,248 @@ UBlueprintMessage* UBlueprintMessage::FillNamedSlot(FName Name, const FBlueprint
 
 UBlueprintMessage* UBlueprintMessage::SetSeverity(EBlueprintMessageSeverity NewSeverity)
 {
-	Severity = NewSeverity;
+	if (Severity != NewSeverity && CheckNotReleased())
+	{
+		Severity = NewSeverity;
+		InvalidateBuiltMessage();
+	}
 	return this;
 }
 
 UBlueprintMessage* UBlueprintMessage::ClearTokens()
 {
-	Tokens.Empty();
+	if (!CheckNotReleased())
+	{
+		return this;
+	}
+
+	Tokens.Reset();
+	InvalidateBuiltMessage();
 	return this;
 }
 
+bool UBlueprintMessage::IsEnabled() const
+{
+	return FBlueprintMessageCategoryGate::IsEnabled(Category, Severity);
+}
+
 void UBlueprintMessage::Show()
 {
-#if WITH_EDITOR
+	if (!CheckNotReleased())
+	{
+		return;
+	}
+
+	if (HasMessageConsumers()
+		&& FBlueprintMessageCategoryGate::IsEnabled(Category, Severity)
+		&& !IsRepeatSuppressed(Category, Severity, InitialMessage, Tokens, bSuppressLoggingToOutputLog, CallSiteId))
 	{
 		FTagToMessage TagToMessage = BuildMessage();
 		ShowImpl(TagToMessage.Key, TagToMessage.Value);
 	}
-#endif
 
 	if (bAutoDestroy)
 	{
-		Destroy();
+		// caller may still hold the message, recycled object would be reused by unrelated message
+		DestroyImpl(false);
 	}
 }
 
 void UBlueprintMessage::ShowAndPrint(bool bPrintToScreen, bool bPrintToLog, FLinearColor TextColor, float Duration, const FName Key)
 {
-#if WITH_EDITOR
+	SCOPE_CYCLE_COUNTER(STAT_BlueprintMessage_ShowAndPrint);
+
+	if (!CheckNotReleased())
+	{
+		return;
+	}
+
+	if (FBlueprintMessageCategoryGate::IsEnabled(Category, Severity)
+		&& !IsRepeatSuppressed(Category, Severity, InitialMessage, Tokens, bSuppressLoggingToOutputLog, CallSiteId))
 	{
 		FTagToMessage TagToMessage = BuildMessage();
 
 		ShowImpl(TagToMessage.Key, TagToMessage.Value);
 
-		FStringBuilderBase LongMessage;
-		LongMessage.Append(TagToMessage.Key.ToString());
-		LongMessage.Append(TEXT(": "));
-		LongMessage.Append(TagToMessage.Value->ToText().ToString());
+		if (bPrintToScreen || bPrintToLog)
+		{
+			// repeated prints of unchanged message reuse line rendered by the first one,
+			// cache is owned by game thread and dynamic text can change between prints
+			const bool bCacheLine = IsInGameThread() && !FBlueprintMessageTextRenderer::HasDynamicTokens(*TagToMessage.Value);
+			TSharedPtr<const FString, ESPMode::ThreadSafe> PrintLine = bCacheLine ? CachedPrintLine : nullptr;
+			if (!PrintLine.IsValid())
+			{
+				TStringBuilder<512> Line;
+				FBlueprintMessageTextRenderer::RenderLine(TagToMessage.Key, *TagToMessage.Value, Line);
+				PrintLine = MakeShared<FString, ESPMode::ThreadSafe>(Line.ToView());
+				if (bCacheLine)
+				{
+					CachedPrintLine = PrintLine;
+				}
+			}
 
-		UKismetSystemLibrary::PrintText(nullptr, FText::FromString(LongMessage.ToString()), bPrintToScreen, bPrintToLog, TextColor, Duration, Key);
+			UKismetSystemLibrary::PrintString(nullptr, *PrintLine, bPrintToScreen, bPrintToLog, TextColor, Duration, Key);
+		}
 	}
-#endif
 
 	if (bAutoDestroy)
 	{
-		Destroy();
+		DestroyImpl(false);
 	}
 }
 
 void UBlueprintMessage::ShowImpl(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage) const
 {
-	UE_LOG(LogBlueprintMessage, Verbose, TEXT("Show UBlueprintMessage at %p to target %s with %d tokens"), this, *InCategory.ToString(), Tokens.Num());
+	ShowImpl(InCategory, InMessage, bSuppressLoggingToOutputLog, CallSiteId);
+}
+
+void UBlueprintMessage::ShowImpl(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage, bool bInSuppressLoggingToOutputLog, uint32 InCallSiteId)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BlueprintMessage_Show);
+
+	// message log and sinks are not safe to use outside of game thread, hand message over to game thread
+	if (!IsInGameThread())
+	{
+		if (FBlueprintMessageQueue* Queue = FBlueprintMessageQueue::Get())
+		{
+			Queue->EnqueueFromAnyThread(InCategory, InMessage, bInSuppressLoggingToOutputLog, InCallSiteId);
+		}
+		return;
+	}
+
+	FBlueprintMessageStats::CountShown(InCategory, InMessage->GetSeverity(), InMessage->GetMessageTokens().Num());
+	FBlueprintMessageTrace::OutputMessage(InCategory, InMessage, InCallSiteId);
+	FBlueprintMessageSinks::Dispatch(InCategory, InMessage, InCallSiteId);
 
 #if WITH_EDITOR
+	if (UBlueprintMessageSettings::Get()->bBatchMessageDelivery)
+	{
+		if (FBlueprintMessageQueue* Queue = FBlueprintMessageQueue::Get())
+		{
+			Queue->Enqueue(InCategory, InMessage, bInSuppressLoggingToOutputLog);
+			return;
+		}
+	}
+
 	{
 		FMessageLog Log(InCategory);
-		Log.SuppressLoggingToOutputLog(bSuppressLoggingToOutputLog);
+		Log.SuppressLoggingToOutputLog(bInSuppressLoggingToOutputLog);
 		Log.AddMessage(InMessage);
 		// ~FMessageLog() -> Log.Flush();
 	}
 #endif
 }
 
+bool UBlueprintMessage::HasMessageConsumers()
+{
+#if WITH_EDITOR
+	return true;
+#else
+	return FBlueprintMessageSinks::HasSinks() || FBlueprintMessageTrace::IsEnabled();
+#endif
+}
+
+bool UBlueprintMessage::IsRepeatSuppressed(const FName& InCategory, EBlueprintMessageSeverity InSeverity, const FText& InInitialMessage, const TArray<FBlueprintMessageToken>& InTokens, bool bInSuppressLoggingToOutputLog, uint32 InCallSiteId)
+{
+	FBlueprintMessageSuppressor* Suppressor = FBlueprintMessageSuppressor::Get();
+	if (!Suppressor)
+	{
+		return false;
+	}
+
+	const FName MessageCat = InCategory.IsNone() ? UBlueprintMessageSettings::Get()->GetDefaultCategory() : InCategory;
+	return Suppressor->ShouldSuppress(MessageCat, InSeverity, InInitialMessage, InTokens, bInSuppressLoggingToOutputLog, InCallSiteId);
+}
+
 UBlueprintMessage::FTagToMessage UBlueprintMessage::BuildMessage() const
 {
-	FName MessageCat = Category;
+	// cache is owned by game thread, worker threads build their own copy
+	if (!IsInGameThread())
+	{
+		return BuildMessage(Category, Severity, InitialMessage, Tokens);
+	}
+
+	// reuse message built by previous show if nothing changed since
+	if (!CachedMessage.IsValid())
+	{
+		FTagToMessage Built = BuildMessage(Category, Severity, InitialMessage, Tokens);
+		CachedCategory = Built.Key;
+		CachedMessage = Built.Value;
+		return Built;
+	}
+	return MakeTuple(CachedCategory, CachedMessage.ToSharedRef());
+}
+
+namespace
+{
+	struct FSlotPlaceholders
+	{
+		FRWLock Lock;
+		TMap<FName, TSharedRef<IMessageToken>> BySlot;
+		TMap<const IMessageToken*, FName> ByToken;
+
+		static FSlotPlaceholders& Get()
+		{
+			static FSlotPlaceholders Placeholders;
+			return Placeholders;
+		}
+	};
+}
+
+TSharedRef<IMessageToken> UBlueprintMessage::GetSlotPlaceholder(const FName& InSlot)
+{
+	FSlotPlaceholders& Placeholders = FSlotPlaceholders::Get();
+
+	{
+		FReadScopeLock ReadLock(Placeholders.Lock);
+		if (const TSharedRef<IMessageToken>* Existing = Placeholders.BySlot.Find(InSlot))
+		{
+			return *Existing;
+		}
+	}
+
+	FWriteScopeLock WriteLock(Placeholders.Lock);
+	if (const TSharedRef<IMessageToken>* Existing = Placeholders.BySlot.Find(InSlot))
+	{
+		return *Existing;
+	}
+	TSharedRef<IMessageToken> Placeholder = FTextToken::Create(FText::FromString(FString::Printf(TEXT("{%s}"), *InSlot.ToString())));
+	Placeholders.BySlot.Add(InSlot, Placeholder);
+	Placeholders.ByToken.Add(&Placeholder.Get(), InSlot);
+	return Placeholder;
+}
+
+FName UBlueprintMessage::FindSlotOfPlaceholder(const IMessageToken& InToken)
+{
+	FSlotPlaceholders& Placeholders = FSlotPlaceholders::Get();
+
+	FReadScopeLock ReadLock(Placeholders.Lock);
+	const FName* Slot = Placeholders.ByToken.Find(&InToken);
+	return Slot ? *Slot : NAME_None;
+}
+
+UBlueprintMessage::FTagToMessage UBlueprintMessage::BuildMessage(const FName& InCategory, EBlueprintMessageSeverity InSeverity, const FText& InInitialMessage, const TArray<FBlueprintMessageToken>& InTokens)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BlueprintMessage_Build);
+
+	FName MessageCat = InCategory;
 	if (MessageCat.IsNone())
 	{
 		MessageCat = UBlueprintMessageSettings::Get()->GetDefaultCategory();
 	}
 
-	TSharedRef<FTokenizedMessage> MessagePtr = FTokenizedMessage::Create(static_cast<EMessageSeverity::Type>(Severity), InitialMessage);
+	TSharedRef<FTokenizedMessage> MessagePtr = FTokenizedMessage::Create(static_cast<EMessageSeverity::Type>(InSeverity), InInitialMessage);
 
-	for (const FBlueprintMessageToken& Token : Tokens)
+	for (const FBlueprintMessageToken& Token : InTokens)
 	{
-		// dump all messages except empty slots
-		if (Token.Instance.IsValid())
+		// engine tokens are created from inline content only here, empty slots get placeholder
+		if (TSharedPtr<IMessageToken> Instance = Token.GetToken())
 		{
-			MessagePtr->AddToken(Token.Instance.ToSharedRef());
+			MessagePtr->AddToken(Instance.ToSharedRef());
 		}
 		else
 		{
-			MessagePtr->AddToken(FTextToken::Create(FText::FromString(FString::Printf(TEXT("{%s}"), *Token.Name.ToString()))));
+			MessagePtr->AddToken(GetSlotPlaceholder(Token.Name));
 		}
 	}
 
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "BlueprintMessageToken.h"
+#include "BlueprintMessageTokenList.h"
 #include "UObject/Object.h"
 #include "BlueprintMessage.generated.h"
 
@@ -23,12 +24,14 @@ public:
 	 *
 	 * @param LogCategory message log category for this message
 	 * @param Severity severity of this message
+	 * @param CallSiteId id of node creating the message, set by Create Message node
 	 * @returns message instance
 	 */
-	UFUNCTION(BlueprintCallable, DisplayName="Create Log Message", Category="Utilities|MessageLog", meta=(BlueprintInternalUseOnly=true, Keywords="create message"))
+	UFUNCTION(BlueprintCallable, DisplayName="Create Log Message", Category="Utilities|MessageLog", meta=(BlueprintInternalUseOnly=true, HidePin="CallSiteId", Keywords="create message"))
 	static UPARAM(DisplayName="Message") UBlueprintMessage* CreateBlueprintMessage(
 		UPARAM(DisplayName="Category", meta=(GetOptions="BlueprintMessage.BlueprintMessageLibrary.GetAvailableCategories")) FName LogCategory = TEXT("BlueprintLog"),
-		EBlueprintMessageSeverity Severity = EBlueprintMessageSeverity::Info);
+		EBlueprintMessageSeverity Severity = EBlueprintMessageSeverity::Info,
+		int32 CallSiteId = 0);
 
 	/**
 	 * Construct new message instance with initial text.
@@ -61,7 +64,9 @@ public:
 	UPARAM(DisplayName="Message") UBlueprintMessage* Duplicate();
 
 	/**
-	 * Explicitly destroy message object and mark it as garbage
+	 * Explicitly destroy message object and mark it as garbage.
+	 * If message pool is enabled the object is reset and recycled instead, calls on it are ignored until it is reused.
+	 * Messages destroyed automatically after Show are never recycled, so references kept by caller stay invalid.
 	 */
 	UFUNCTION(BlueprintCallable, Category="Utilities|MessageLog")
 	void Destroy();
@@ -70,6 +75,10 @@ public:
 	UFUNCTION(BlueprintCallable, meta=(AutoCreateRefTerm="Token"), Category="Utilities|MessageLog")
 	UPARAM(DisplayName="Message") UBlueprintMessage* AddToken(const FBlueprintMessageToken& Token, FName Slot = NAME_None);
 
+	/** Add token and stamp message with call site of adding node if it has none yet. Used by Add Token nodes. */
+	UFUNCTION(BlueprintCallable, meta=(BlueprintInternalUseOnly=true, AutoCreateRefTerm="Token"), Category="Utilities|MessageLog")
+	UPARAM(DisplayName="Message") UBlueprintMessage* AddTokenAtCallSite(const FBlueprintMessageToken& Token, FName Slot, int32 CallSiteId);
+
 	/** Add multiple tokens to this message */
 	UFUNCTION(BlueprintCallable, meta=(AutoCreateRefTerm="Tokens"), Category="Utilities|MessageLog")
 	UPARAM(DisplayName="Message") UBlueprintMessage* AddTokens(const TArray<FBlueprintMessageToken>& Tokens);
@@ -104,15 +113,62 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Utilities|MessageLog")
 	UPARAM(DisplayName="Message") UBlueprintMessage* SetSeverity(EBlueprintMessageSeverity Severity);
 
+	/** Get id of blueprint node that produced this message, 0 if unknown. See FBlueprintMessageCallSiteRegistry. */
+	uint32 GetCallSiteId() const { return CallSiteId; }
+
+	/** Is category and severity of this message enabled by console variables. Add Token nodes branch on this before token is created. */
+	UFUNCTION(BlueprintPure, Category="Utilities|MessageLog", meta=(BlueprintInternalUseOnly=true))
+	bool IsEnabled() const;
+
 protected:
+	friend class FBlueprintMessagePool;
 
 	static UBlueprintMessage* CreateMessageImpl();
 
+	/* Restore message to a freshly constructed state */
+	void ResetMessage();
+
+	/* Destroy message, recycling it into pool if allowed */
+	void DestroyImpl(bool bAllowPool);
+
+	/* Is message usable, warns about calls on message idle in pool */
+	bool CheckNotReleased() const;
+
+	/* Drop cached built message after any change to message content */
+	void InvalidateBuiltMessage();
+
+	/* Get shared placeholder token displayed for an empty slot */
+	static TSharedRef<IMessageToken> GetSlotPlaceholder(const FName& InSlot);
+
+public:
+	/* Get name of unfilled slot if token is a slot placeholder of built message, None otherwise */
+	static FName FindSlotOfPlaceholder(const IMessageToken& InToken);
+
+protected:
+
+	friend struct FBlueprintMessageBuilder;
+	friend struct FBlueprintMessageTemplate;
+	friend struct FBlueprintMessageTemplateInstance;
+	friend class UBlueprintMessageTemplateLibrary;
+	friend class FBlueprintMessageSuppressor;
+
 	using FTagToMessage = TPair<FName, TSharedRef<FTokenizedMessage>>;
 	FTagToMessage BuildMessage() const;
 
+	/* Build engine message from raw message state, shared by message objects and builders */
+	static FTagToMessage BuildMessage(const FName& InCategory, EBlueprintMessageSeverity InSeverity, const FText& InInitialMessage, const TArray<FBlueprintMessageToken>& InTokens);
+
 	void ShowImpl(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage) const;
 
+	/* Is there anything to receive shown message in current configuration */
+	static bool HasMessageConsumers();
+
+	/* Check message against repeat suppression before it is built */
+	static bool IsRepeatSuppressed(const FName& InCategory, EBlueprintMessageSeverity InSeverity, const FText& InInitialMessage, const TArray<FBlueprintMessageToken>& InTokens, bool bInSuppressLoggingToOutputLog, uint32 InCallSiteId = 0);
+
+	/* Deliver built message to message log */
+	static void ShowImpl(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage, bool bInSuppressLoggingToOutputLog, uint32 InCallSiteId = 0);
+
 	UPROPERTY()
 	FName Category = TEXT("BlueprintLog");
 
@@ -122,9 +178,18 @@ protected:
 	UPROPERTY()
 	FText InitialMessage;
 
-	/** Stream of tokens for this message */
-	UPROPERTY()
-	TArray<FBlueprintMessageToken> Tokens;
+	/* Id of blueprint node that produced this message, 0 if unknown */
+	uint32 CallSiteId = 0;
+
+	/** Stream of tokens and slot index for this message, shared with duplicates until modified */
+	FBlueprintMessageTokenList Tokens;
+
+	/* Message built by previous show, reused while content is unchanged */
+	mutable TSharedPtr<FTokenizedMessage> CachedMessage;
+	/* Category resolved for cached message */
+	mutable FName CachedCategory;
+	/* Line printed by ShowAndPrint for cached message, rendered on first print and shared with duplicates */
+	mutable TSharedPtr<const FString, ESPMode::ThreadSafe> CachedPrintLine;
 
 	/** Should we mirror message log messages from this instance to the output log? */
 	UPROPERTY(BlueprintReadWrite, Category=Message, meta=(AllowPrivateAccess))
@@ -133,6 +198,9 @@ protected:
 	/** Should message be automatically destroyed after Show() call? */
 	UPROPERTY(BlueprintReadWrite, Category=Message, meta=(AllowPrivateAccess))
 	bool bAutoDestroy = false;
+
+	/* Is message currently idle in message pool */
+	bool bInPool = false;
 };
 
 DECLARE_LOG_CATEGORY_EXTERN(LogBlueprintMessage, Log, All);
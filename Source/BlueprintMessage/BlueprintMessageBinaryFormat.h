@@ -0,0 +1,67 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Binary message log file layout.
+ *
+ * File starts with header: uint32 Magic, uint32 Version.
+ * Followed by a stream of records, each starting with uint8 record type.
+ *
+ * Text:
+ *   uint32 Length, Length bytes of UTF-8 text
+ *
+ * String record:
+ *   uint32 Id, text
+ *   Category names, paths, format patterns and argument names are written once before first record that refers to them.
+ *
+ * Message record:
+ *   int64 UTC ticks, uint32 Category string Id, uint8 Severity, uint16 NumTokens, tokens
+ *
+ * Token:
+ *   uint8 EMessageToken::Type, text (uint32 text string Id in version 1), type specific payload:
+ *     Object     - uint32 object path string Id
+ *     Actor      - uint32 actor path string Id, FGuid (4 x uint32)
+ *     AssetName  - uint32 asset path string Id
+ *     URL        - uint32 url string Id
+ *     Image      - uint32 image name string Id
+ *     Documentation - uint32 documentation link string Id
+ *   Other token types have no payload.
+ *
+ * Format text token (version 2), stored unformatted in place of text token:
+ *   uint8 EDeferredTokenType::FormatText, uint32 pattern string Id, uint8 NumArguments, arguments:
+ *     uint32 name string Id, uint8 EFormatArgumentType, value:
+ *       Int, UInt - int64
+ *       Float     - float
+ *       Double    - double
+ *       Text      - text
+ *       Gender    - uint8 ETextGender
+ *
+ * Timestamp token (version 2), stored as captured time in place of text token:
+ *   uint8 EDeferredTokenType::Timestamp, int64 UTC ticks, uint64 frame, double seconds since process start,
+ *   int32 timecode hours, minutes, seconds, frames, uint8 timecode drop frame,
+ *   uint8 EBlueprintMessageTimestampType, uint8 include frame
+ *
+ * All values are little endian.
+ */
+namespace BlueprintMessageBinaryFormat
+{
+	static constexpr uint32 Magic = 0x4C4D5042; // 'BPML'
+	static constexpr uint32 Version = 2;
+
+	enum class ERecordType : uint8
+	{
+		String = 1,
+		Message = 2,
+	};
+
+	/* Type byte of plugin tokens stored unformatted, engine tokens use EMessageToken::Type values below */
+	enum class EDeferredTokenType : uint8
+	{
+		None = 0,
+		FormatText = 0x80,
+		Timestamp = 0x81,
+	};
+}
@@ -0,0 +1,364 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageBinaryReader.h"
+#include "BlueprintMessageBinaryFormat.h"
+#include "BlueprintMessage.h"
+#include "BlueprintMessageTimestampToken.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Internationalization/TextFormatter.h"
+#include "Misc/EngineVersionComparison.h"
+
+FBlueprintMessageBinaryReader::FBlueprintMessageBinaryReader() = default;
+
+FBlueprintMessageBinaryReader::~FBlueprintMessageBinaryReader()
+{
+	// region must be released before its file handle
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+bool FBlueprintMessageBinaryReader::Open(const FString& InFilePath)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+#if UE_VERSION_OLDER_THAN(5, 3, 0)
+	MappedFile.Reset(PlatformFile.OpenMapped(*InFilePath));
+#else
+	FOpenMappedResult Result = PlatformFile.OpenMappedEx(*InFilePath);
+	if (Result.HasValue())
+	{
+		MappedFile = Result.StealValue();
+	}
+#endif
+	if (!MappedFile.IsValid() || MappedFile->GetFileSize() == 0)
+	{
+		UE_LOG(LogBlueprintMessage, Error, TEXT("Failed to map binary message file %s"), *InFilePath);
+		return false;
+	}
+
+	MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	if (!MappedRegion.IsValid())
+	{
+		UE_LOG(LogBlueprintMessage, Error, TEXT("Failed to map binary message file %s"), *InFilePath);
+		return false;
+	}
+
+	Data = MappedRegion->GetMappedPtr();
+	Size = MappedRegion->GetMappedSize();
+	Offset = 0;
+	bError = false;
+	Strings.Reset();
+
+	uint32 Magic = 0;
+	Version = 0;
+	if (!Read(Magic) || !Read(Version) || Magic != BlueprintMessageBinaryFormat::Magic)
+	{
+		UE_LOG(LogBlueprintMessage, Error, TEXT("File %s is not a binary message file"), *InFilePath);
+		bError = true;
+		return false;
+	}
+	if (Version > BlueprintMessageBinaryFormat::Version)
+	{
+		UE_LOG(LogBlueprintMessage, Error, TEXT("File %s has unsupported version %u"), *InFilePath, Version);
+		bError = true;
+		return false;
+	}
+	return true;
+}
+
+bool FBlueprintMessageBinaryReader::Next(FBlueprintMessageBinaryRecord& OutRecord)
+{
+	while (!bError && Offset < Size)
+	{
+		const int64 RecordStart = Offset;
+
+		uint8 RecordType = 0;
+		Read(RecordType);
+
+		bool bValid = false;
+		switch (static_cast<BlueprintMessageBinaryFormat::ERecordType>(RecordType))
+		{
+		case BlueprintMessageBinaryFormat::ERecordType::String:
+			bValid = ReadString();
+			break;
+		case BlueprintMessageBinaryFormat::ERecordType::Message:
+			if (ReadMessage(OutRecord))
+			{
+				return true;
+			}
+			break;
+		default:
+			break;
+		}
+
+		if (!bValid)
+		{
+			// file may still be written by running session, incomplete tail is not reported
+			UE_CLOG(RecordStart + 64 < Size, LogBlueprintMessage, Warning, TEXT("Malformed binary message record at offset %lld"), RecordStart);
+			Offset = RecordStart;
+			bError = true;
+		}
+	}
+	return false;
+}
+
+bool FBlueprintMessageBinaryReader::ReadText(FUtf8StringView& OutText)
+{
+	uint32 Length = 0;
+	if (!Read(Length) || Offset + Length > Size)
+	{
+		return false;
+	}
+	OutText = FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Data + Offset), Length);
+	Offset += Length;
+	return true;
+}
+
+bool FBlueprintMessageBinaryReader::ReadString()
+{
+	uint32 Id = 0;
+	FUtf8StringView Text;
+	if (!Read(Id) || Id != static_cast<uint32>(Strings.Num()) || !ReadText(Text))
+	{
+		return false;
+	}
+	Strings.Emplace(Offset - Text.Len(), Text.Len());
+	return true;
+}
+
+bool FBlueprintMessageBinaryReader::ReadMessage(FBlueprintMessageBinaryRecord& OutRecord)
+{
+	uint8 Severity = 0;
+	uint16 NumTokens = 0;
+	if (!Read(OutRecord.Ticks) || !Read(OutRecord.CategoryId) || !Read(Severity) || !Read(NumTokens))
+	{
+		return false;
+	}
+	OutRecord.Severity = static_cast<EMessageSeverity::Type>(Severity);
+
+	OutRecord.Tokens.Reset();
+	for (uint16 Index = 0; Index < NumTokens; ++Index)
+	{
+		FBlueprintMessageBinaryToken& Token = OutRecord.Tokens.AddDefaulted_GetRef();
+
+		uint8 Type = 0;
+		if (!Read(Type))
+		{
+			return false;
+		}
+
+		if (Type == static_cast<uint8>(BlueprintMessageBinaryFormat::EDeferredTokenType::FormatText))
+		{
+			if (!ReadFormatToken(Token))
+			{
+				return false;
+			}
+			continue;
+		}
+		if (Type == static_cast<uint8>(BlueprintMessageBinaryFormat::EDeferredTokenType::Timestamp))
+		{
+			if (!ReadTimestampToken(Token))
+			{
+				return false;
+			}
+			continue;
+		}
+
+		if (Version < 2)
+		{
+			// text was stored in string table
+			uint32 TextId = 0;
+			if (!Read(TextId))
+			{
+				return false;
+			}
+			Token.Text = GetStringView(TextId);
+		}
+		else if (!ReadText(Token.Text))
+		{
+			return false;
+		}
+		Token.Type = static_cast<EMessageToken::Type>(Type);
+
+		switch (Token.Type)
+		{
+		case EMessageToken::Object:
+		case EMessageToken::Actor:
+		case EMessageToken::AssetName:
+		case EMessageToken::URL:
+		case EMessageToken::Image:
+		case EMessageToken::Documentation:
+			Token.bHasPayload = true;
+			if (!Read(Token.PayloadId))
+			{
+				return false;
+			}
+			break;
+		default:
+			break;
+		}
+
+		if (Token.Type == EMessageToken::Actor)
+		{
+			if (!Read(Token.ActorGuid.A) || !Read(Token.ActorGuid.B) || !Read(Token.ActorGuid.C) || !Read(Token.ActorGuid.D))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool FBlueprintMessageBinaryReader::ReadFormatToken(FBlueprintMessageBinaryToken& OutToken)
+{
+	OutToken.Type = EMessageToken::Text;
+	OutToken.DeferredType = BlueprintMessageBinaryFormat::EDeferredTokenType::FormatText;
+
+	uint8 NumArguments = 0;
+	if (!Read(OutToken.PatternId) || !Read(NumArguments))
+	{
+		return false;
+	}
+
+	for (uint8 Index = 0; Index < NumArguments; ++Index)
+	{
+		FBlueprintMessageBinaryArgument& Argument = OutToken.Arguments.AddDefaulted_GetRef();
+
+		uint8 Type = 0;
+		if (!Read(Argument.NameId) || !Read(Type))
+		{
+			return false;
+		}
+		Argument.Type = static_cast<EFormatArgumentType::Type>(Type);
+
+		bool bValid = false;
+		switch (Argument.Type)
+		{
+		case EFormatArgumentType::Int:
+		case EFormatArgumentType::UInt:
+			bValid = Read(Argument.IntValue);
+			break;
+		case EFormatArgumentType::Float:
+			{
+				float Value = 0;
+				bValid = Read(Value);
+				Argument.DoubleValue = Value;
+				break;
+			}
+		case EFormatArgumentType::Double:
+			bValid = Read(Argument.DoubleValue);
+			break;
+		case EFormatArgumentType::Text:
+			bValid = ReadText(Argument.TextValue);
+			break;
+		case EFormatArgumentType::Gender:
+			{
+				uint8 Value = 0;
+				bValid = Read(Value);
+				Argument.IntValue = Value;
+				break;
+			}
+		default:
+			break;
+		}
+
+		if (!bValid)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FBlueprintMessageBinaryReader::ReadTimestampToken(FBlueprintMessageBinaryToken& OutToken)
+{
+	OutToken.Type = EMessageToken::Text;
+	OutToken.DeferredType = BlueprintMessageBinaryFormat::EDeferredTokenType::Timestamp;
+
+	FBlueprintMessageBinaryTimestamp& Timestamp = OutToken.Timestamp;
+	uint8 bDropFrame = 0, bIncludeFrame = 0;
+	if (!Read(Timestamp.UtcTicks) || !Read(Timestamp.Frame) || !Read(Timestamp.Seconds)
+		|| !Read(Timestamp.Timecode.Hours) || !Read(Timestamp.Timecode.Minutes) || !Read(Timestamp.Timecode.Seconds) || !Read(Timestamp.Timecode.Frames)
+		|| !Read(bDropFrame) || !Read(Timestamp.Type) || !Read(bIncludeFrame))
+	{
+		return false;
+	}
+	Timestamp.Timecode.bDropFrameFormat = bDropFrame != 0;
+	Timestamp.bIncludeFrame = bIncludeFrame != 0;
+	return Timestamp.Type <= static_cast<uint8>(EBlueprintMessageTimestampType::Timecode);
+}
+
+FUtf8StringView FBlueprintMessageBinaryReader::GetStringView(uint32 Id) const
+{
+	if (!Strings.IsValidIndex(Id))
+	{
+		return FUtf8StringView();
+	}
+	const TPair<int64, int32>& Entry = Strings[Id];
+	return FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Data + Entry.Key), Entry.Value);
+}
+
+FString FBlueprintMessageBinaryReader::GetString(uint32 Id) const
+{
+	return FString(GetStringView(Id));
+}
+
+void FBlueprintMessageBinaryReader::AppendTokenText(const FBlueprintMessageBinaryToken& InToken, FStringBuilderBase& OutBuilder) const
+{
+	if (InToken.DeferredType == BlueprintMessageBinaryFormat::EDeferredTokenType::FormatText)
+	{
+		TArray<FFormatArgumentData> Arguments;
+		Arguments.Reserve(InToken.Arguments.Num());
+		for (const FBlueprintMessageBinaryArgument& Argument : InToken.Arguments)
+		{
+			FFormatArgumentData& Data = Arguments.AddDefaulted_GetRef();
+			Data.ArgumentName = GetString(Argument.NameId);
+			Data.ArgumentValueType = Argument.Type;
+			switch (Argument.Type)
+			{
+			case EFormatArgumentType::Text:
+				Data.ArgumentValue = FText::FromString(FString(Argument.TextValue));
+				break;
+			case EFormatArgumentType::Gender:
+				Data.ArgumentValueGender = static_cast<ETextGender>(Argument.IntValue);
+				break;
+			case EFormatArgumentType::Float:
+				Data.ArgumentValueFloat = static_cast<float>(Argument.DoubleValue);
+				break;
+			case EFormatArgumentType::Double:
+				Data.ArgumentValueDouble = Argument.DoubleValue;
+				break;
+			default:
+				Data.ArgumentValueInt = Argument.IntValue;
+				break;
+			}
+		}
+
+		// same formatting path as FBlueprintMessageFormatToken
+		OutBuilder.Append(FTextFormatter::Format(FTextFormat::FromString(GetString(InToken.PatternId)), MoveTemp(Arguments), false, false).ToString());
+		return;
+	}
+
+	if (InToken.DeferredType == BlueprintMessageBinaryFormat::EDeferredTokenType::Timestamp)
+	{
+		// elapsed time is stored relative to writing process, capture is rebased onto this one
+		FBlueprintMessageTimestampCapture Capture;
+		Capture.UtcTicks = InToken.Timestamp.UtcTicks;
+		Capture.Frame = InToken.Timestamp.Frame;
+		Capture.Seconds = InToken.Timestamp.Seconds + GStartTime;
+		Capture.Timecode = InToken.Timestamp.Timecode;
+		FBlueprintMessageTimestampToken::Format(Capture, static_cast<EBlueprintMessageTimestampType>(InToken.Timestamp.Type), InToken.Timestamp.bIncludeFrame, OutBuilder);
+		return;
+	}
+
+	const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(InToken.Text.GetData()), InToken.Text.Len());
+	OutBuilder.Append(Converted.Get(), Converted.Length());
+}
+
+FString FBlueprintMessageBinaryReader::GetTokenText(const FBlueprintMessageBinaryToken& InToken) const
+{
+	TStringBuilder<256> Builder;
+	AppendTokenText(InToken, Builder);
+	return FString(Builder.ToView());
+}
@@ -0,0 +1,154 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Logging/TokenizedMessage.h"
+#include "BlueprintMessageBinaryFormat.h"
+#include "Misc/Timecode.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Argument of format text token
+ */
+struct FBlueprintMessageBinaryArgument
+{
+	uint32 NameId = 0;
+	EFormatArgumentType::Type Type = EFormatArgumentType::Int;
+	/* Int, UInt and Gender values */
+	int64 IntValue = 0;
+	/* Float and Double values */
+	double DoubleValue = 0;
+	/* Text value, points into mapped file */
+	FUtf8StringView TextValue;
+};
+
+/**
+ * Captured time of timestamp token
+ */
+struct FBlueprintMessageBinaryTimestamp
+{
+	int64 UtcTicks = 0;
+	uint64 Frame = 0;
+	/* Seconds since start of process that wrote the file */
+	double Seconds = 0;
+	FTimecode Timecode;
+	/* EBlueprintMessageTimestampType */
+	uint8 Type = 0;
+	bool bIncludeFrame = false;
+};
+
+/**
+ * Single token of a binary message record
+ */
+struct FBlueprintMessageBinaryToken
+{
+	EMessageToken::Type Type = EMessageToken::Text;
+	/* Plugin token stored unformatted, Type is EMessageToken::Text for those */
+	BlueprintMessageBinaryFormat::EDeferredTokenType DeferredType = BlueprintMessageBinaryFormat::EDeferredTokenType::None;
+	/* Token text, points into mapped file and is valid while reader is open */
+	FUtf8StringView Text;
+	/* Pattern string id for format text token */
+	uint32 PatternId = 0;
+	/* Type specific payload string id, valid if bHasPayload */
+	uint32 PayloadId = 0;
+	bool bHasPayload = false;
+	/* Actor guid for actor tokens */
+	FGuid ActorGuid;
+	/* Arguments of format text token */
+	TArray<FBlueprintMessageBinaryArgument> Arguments;
+	/* Captured time of timestamp token */
+	FBlueprintMessageBinaryTimestamp Timestamp;
+};
+
+/**
+ * Single message record of binary message log
+ */
+struct FBlueprintMessageBinaryRecord
+{
+	/* UTC time of message in ticks */
+	int64 Ticks = 0;
+	uint32 CategoryId = 0;
+	EMessageSeverity::Type Severity = EMessageSeverity::Info;
+	TArray<FBlueprintMessageBinaryToken, TInlineAllocator<8>> Tokens;
+};
+
+/**
+ * Sequential reader for files produced by FBlueprintMessageBinarySink.
+ *
+ * File is memory mapped, strings are decoded only when requested.
+ *
+ * @see BlueprintMessageBinaryFormat
+ */
+class BLUEPRINTMESSAGE_API FBlueprintMessageBinaryReader
+{
+public:
+	FBlueprintMessageBinaryReader();
+	~FBlueprintMessageBinaryReader();
+
+	/* Open file and validate header */
+	bool Open(const FString& InFilePath);
+
+	/**
+	 * Read next message record, string records met on the way are added to string table.
+	 *
+	 * @returns false at end of file or if data is malformed
+	 */
+	bool Next(FBlueprintMessageBinaryRecord& OutRecord);
+
+	/* Did reader stop because of malformed or truncated data */
+	bool HasError() const { return bError; }
+
+	/* Number of strings read so far */
+	int32 NumStrings() const { return Strings.Num(); }
+
+	/* Raw UTF-8 string by id, empty if unknown */
+	FUtf8StringView GetStringView(uint32 Id) const;
+
+	/* Decoded string by id, empty if unknown */
+	FString GetString(uint32 Id) const;
+
+	/* Append display text of token, formatting tokens stored unformatted */
+	void AppendTokenText(const FBlueprintMessageBinaryToken& InToken, FStringBuilderBase& OutBuilder) const;
+
+	/* Display text of token */
+	FString GetTokenText(const FBlueprintMessageBinaryToken& InToken) const;
+
+	/* Total size of the file */
+	int64 GetSize() const { return Size; }
+	/* Current read position */
+	int64 GetOffset() const { return Offset; }
+
+private:
+	template<typename T>
+	bool Read(T& OutValue)
+	{
+		if (Offset + static_cast<int64>(sizeof(T)) > Size)
+		{
+			return false;
+		}
+		FMemory::Memcpy(&OutValue, Data + Offset, sizeof(T));
+		Offset += sizeof(T);
+		return true;
+	}
+
+	bool ReadText(FUtf8StringView& OutText);
+	bool ReadString();
+	bool ReadMessage(FBlueprintMessageBinaryRecord& OutRecord);
+	bool ReadFormatToken(FBlueprintMessageBinaryToken& OutToken);
+	bool ReadTimestampToken(FBlueprintMessageBinaryToken& OutToken);
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+	int64 Offset = 0;
+	bool bError = false;
+	uint32 Version = 0;
+
+	/* String table, offset and length of UTF-8 data in mapped region */
+	TArray<TPair<int64, int32>> Strings;
+};
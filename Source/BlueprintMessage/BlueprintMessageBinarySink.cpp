@@ -0,0 +1,328 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageBinarySink.h"
+#include "BlueprintMessageBinaryFormat.h"
+#include "BlueprintMessage.h"
+#include "BlueprintMessageFormatToken.h"
+#include "BlueprintMessageTimestampToken.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/UObjectToken.h"
+#include "Logging/TokenizedMessage.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "Binary message format expects little endian platform");
+
+FBlueprintMessageBinarySink::FBlueprintMessageBinarySink(const FString& InFilePath, int32 InBufferSize)
+	: WritePipe(TEXT("BlueprintMessageBinarySink"))
+	, BufferSize(FMath::Max(InBufferSize, 1024))
+{
+	const FString FullPath = FPaths::IsRelative(InFilePath) ? FPaths::Combine(FPaths::ProjectLogDir(), InFilePath) : InFilePath;
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FullPath));
+
+	// every file carries its own string table, so new file is started each run and previous one is kept as backup
+	if (PlatformFile.FileExists(*FullPath))
+	{
+		const FString BackupPath = FPaths::Combine(FPaths::GetPath(FullPath),
+			FString::Printf(TEXT("%s-backup-%s%s"), *FPaths::GetBaseFilename(FullPath), *PlatformFile.GetTimeStamp(*FullPath).ToString(), *FPaths::GetExtension(FullPath, true)));
+		if (!PlatformFile.MoveFile(*BackupPath, *FullPath))
+		{
+			UE_LOG(LogBlueprintMessage, Warning, TEXT("Failed to move previous binary message file to %s"), *BackupPath);
+		}
+	}
+
+	FileHandle.Reset(PlatformFile.OpenWrite(*FullPath, false, true));
+	if (!FileHandle.IsValid())
+	{
+		UE_LOG(LogBlueprintMessage, Warning, TEXT("Failed to open binary message sink file %s"), *FullPath);
+		return;
+	}
+
+	Buffer.Reserve(BufferSize);
+	Write(BlueprintMessageBinaryFormat::Magic);
+	Write(BlueprintMessageBinaryFormat::Version);
+}
+
+FBlueprintMessageBinarySink::~FBlueprintMessageBinarySink()
+{
+	Flush();
+	WritePipe.WaitUntilEmpty();
+}
+
+void FBlueprintMessageBinarySink::WriteText(const FString& InString)
+{
+	const int32 Length = FPlatformString::ConvertedLength<UTF8CHAR>(*InString, InString.Len());
+	Write(static_cast<uint32>(Length));
+
+	const int32 Offset = Buffer.AddUninitialized(Length);
+	FPlatformString::Convert(reinterpret_cast<UTF8CHAR*>(Buffer.GetData() + Offset), Length, *InString, InString.Len());
+}
+
+uint32 FBlueprintMessageBinarySink::WriteString(const FString& InString)
+{
+	const uint32 Id = NextStringId++;
+
+	Write(BlueprintMessageBinaryFormat::ERecordType::String);
+	Write(Id);
+	WriteText(InString);
+
+	return Id;
+}
+
+uint32 FBlueprintMessageBinarySink::GetStringId(const FString& InString)
+{
+	if (const uint32* Existing = StringIds.Find(InString))
+	{
+		return *Existing;
+	}
+	const uint32 Id = WriteString(InString);
+	StringIds.Add(InString, Id);
+	return Id;
+}
+
+uint32 FBlueprintMessageBinarySink::GetStringId(const FName& InName)
+{
+	if (const uint32* Existing = NameIds.Find(InName))
+	{
+		return *Existing;
+	}
+	const uint32 Id = WriteString(InName.ToString());
+	NameIds.Add(InName, Id);
+	return Id;
+}
+
+void FBlueprintMessageBinarySink::ReceiveMessage(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage)
+{
+	if (!FileHandle.IsValid())
+	{
+		return;
+	}
+
+	const TArray<TSharedRef<IMessageToken>>& Tokens = InMessage->GetMessageTokens();
+	const int32 NumTokens = FMath::Min(Tokens.Num(), static_cast<int32>(MAX_uint16));
+
+	// strings referenced by a record must precede it, so payload ids are resolved before writing record header
+	const uint32 CategoryId = GetStringId(InCategory);
+	TokenRecords.Reset();
+	for (int32 Index = 0; Index < NumTokens; ++Index)
+	{
+		ResolveToken(Tokens[Index], TokenRecords.AddDefaulted_GetRef());
+	}
+
+	Write(BlueprintMessageBinaryFormat::ERecordType::Message);
+	Write(FDateTime::UtcNow().GetTicks());
+	Write(CategoryId);
+	Write(static_cast<uint8>(InMessage->GetSeverity()));
+	Write(static_cast<uint16>(NumTokens));
+
+	for (int32 Index = 0; Index < NumTokens; ++Index)
+	{
+		WriteToken(*Tokens[Index], TokenRecords[Index]);
+	}
+
+	if (Buffer.Num() >= BufferSize)
+	{
+		Submit();
+	}
+}
+
+void FBlueprintMessageBinarySink::ResolveToken(const TSharedRef<IMessageToken>& InToken, FBlueprintMessageBinaryToken& OutRecord)
+{
+	// may emit string records, must not be called while message record is being written
+	if (const FBlueprintMessageFormatToken* FormatToken = FBlueprintMessageFormatToken::Cast(*InToken))
+	{
+		ResolveFormatToken(*FormatToken, OutRecord);
+		return;
+	}
+	if (const FBlueprintMessageTimestampToken* TimestampToken = FBlueprintMessageTimestampToken::Cast(*InToken))
+	{
+		ResolveTimestampToken(*TimestampToken, OutRecord);
+		return;
+	}
+
+	OutRecord.Type = InToken->GetType();
+	OutRecord.bHasPayload = true;
+
+	switch (OutRecord.Type)
+	{
+	case EMessageToken::Object:
+		OutRecord.PayloadId = GetStringId(StaticCastSharedRef<FUObjectToken>(InToken)->GetOriginalObjectPathName());
+		break;
+	case EMessageToken::Actor:
+		OutRecord.PayloadId = GetStringId(StaticCastSharedRef<FActorToken>(InToken)->GetActorPath());
+		OutRecord.ActorGuid = StaticCastSharedRef<FActorToken>(InToken)->GetActorGuid();
+		break;
+	case EMessageToken::AssetName:
+		OutRecord.PayloadId = GetStringId(StaticCastSharedRef<FAssetNameToken>(InToken)->GetAssetName());
+		break;
+	case EMessageToken::URL:
+		OutRecord.PayloadId = GetStringId(StaticCastSharedRef<FURLToken>(InToken)->GetURL());
+		break;
+	case EMessageToken::Image:
+		OutRecord.PayloadId = GetStringId(StaticCastSharedRef<FImageToken>(InToken)->GetImageName());
+		break;
+	case EMessageToken::Documentation:
+		OutRecord.PayloadId = GetStringId(StaticCastSharedRef<FDocumentationToken>(InToken)->GetDocumentationLink());
+		break;
+	default:
+		OutRecord.bHasPayload = false;
+		break;
+	}
+}
+
+void FBlueprintMessageBinarySink::ResolveFormatToken(const FBlueprintMessageFormatToken& InToken, FBlueprintMessageBinaryToken& OutRecord)
+{
+	// pattern and argument values are stored instead of formatted text, text is produced by reader on demand
+	OutRecord.Type = EMessageToken::Text;
+	OutRecord.DeferredType = BlueprintMessageBinaryFormat::EDeferredTokenType::FormatText;
+	OutRecord.PatternId = GetStringId(InToken.GetPattern().ToString());
+
+	const TArray<FFormatArgumentData>& Arguments = InToken.GetArguments();
+	const int32 NumArguments = FMath::Min(Arguments.Num(), static_cast<int32>(MAX_uint8));
+	for (int32 Index = 0; Index < NumArguments; ++Index)
+	{
+		const FFormatArgumentData& Data = Arguments[Index];
+		FBlueprintMessageBinaryArgument& Argument = OutRecord.Arguments.AddDefaulted_GetRef();
+		Argument.NameId = GetStringId(Data.ArgumentName);
+		Argument.Type = Data.ArgumentValueType;
+		switch (Data.ArgumentValueType)
+		{
+		case EFormatArgumentType::Text:
+			// written inline with token
+			break;
+		case EFormatArgumentType::Gender:
+			Argument.IntValue = static_cast<int64>(Data.ArgumentValueGender);
+			break;
+		case EFormatArgumentType::Float:
+			Argument.DoubleValue = Data.ArgumentValueFloat;
+			break;
+		case EFormatArgumentType::Double:
+			Argument.DoubleValue = Data.ArgumentValueDouble;
+			break;
+		default:
+			Argument.IntValue = Data.ArgumentValueInt;
+			break;
+		}
+	}
+}
+
+void FBlueprintMessageBinarySink::ResolveTimestampToken(const FBlueprintMessageTimestampToken& InToken, FBlueprintMessageBinaryToken& OutRecord)
+{
+	const FBlueprintMessageTimestampCapture& Capture = InToken.GetCapture();
+
+	OutRecord.Type = EMessageToken::Text;
+	OutRecord.DeferredType = BlueprintMessageBinaryFormat::EDeferredTokenType::Timestamp;
+	OutRecord.Timestamp.UtcTicks = Capture.UtcTicks;
+	OutRecord.Timestamp.Frame = Capture.Frame;
+	OutRecord.Timestamp.Seconds = Capture.Seconds - GStartTime;
+	OutRecord.Timestamp.Timecode = Capture.Timecode;
+	OutRecord.Timestamp.Type = static_cast<uint8>(InToken.GetTimestampType());
+	OutRecord.Timestamp.bIncludeFrame = InToken.IncludesFrame();
+}
+
+void FBlueprintMessageBinarySink::WriteToken(const IMessageToken& InToken, const FBlueprintMessageBinaryToken& InRecord)
+{
+	switch (InRecord.DeferredType)
+	{
+	case BlueprintMessageBinaryFormat::EDeferredTokenType::FormatText:
+		WriteFormatToken(static_cast<const FBlueprintMessageFormatToken&>(InToken), InRecord);
+		return;
+	case BlueprintMessageBinaryFormat::EDeferredTokenType::Timestamp:
+		WriteTimestampToken(InRecord);
+		return;
+	default:
+		break;
+	}
+
+	// token text is mostly unique, it is written inline instead of growing string table
+	Write(static_cast<uint8>(InRecord.Type));
+	WriteText(InToken.ToText().ToString());
+	if (InRecord.bHasPayload)
+	{
+		Write(InRecord.PayloadId);
+	}
+	if (InRecord.Type == EMessageToken::Actor)
+	{
+		Write(InRecord.ActorGuid.A);
+		Write(InRecord.ActorGuid.B);
+		Write(InRecord.ActorGuid.C);
+		Write(InRecord.ActorGuid.D);
+	}
+}
+
+void FBlueprintMessageBinarySink::WriteFormatToken(const FBlueprintMessageFormatToken& InToken, const FBlueprintMessageBinaryToken& InRecord)
+{
+	Write(InRecord.DeferredType);
+	Write(InRecord.PatternId);
+	Write(static_cast<uint8>(InRecord.Arguments.Num()));
+
+	for (int32 Index = 0; Index < InRecord.Arguments.Num(); ++Index)
+	{
+		const FBlueprintMessageBinaryArgument& Argument = InRecord.Arguments[Index];
+		Write(Argument.NameId);
+		Write(static_cast<uint8>(Argument.Type));
+		switch (Argument.Type)
+		{
+		case EFormatArgumentType::Text:
+			WriteText(InToken.GetArguments()[Index].ArgumentValue.ToString());
+			break;
+		case EFormatArgumentType::Gender:
+			Write(static_cast<uint8>(Argument.IntValue));
+			break;
+		case EFormatArgumentType::Float:
+			Write(static_cast<float>(Argument.DoubleValue));
+			break;
+		case EFormatArgumentType::Double:
+			Write(Argument.DoubleValue);
+			break;
+		default:
+			Write(Argument.IntValue);
+			break;
+		}
+	}
+}
+
+void FBlueprintMessageBinarySink::WriteTimestampToken(const FBlueprintMessageBinaryToken& InRecord)
+{
+	const FBlueprintMessageBinaryTimestamp& Timestamp = InRecord.Timestamp;
+	Write(InRecord.DeferredType);
+	Write(Timestamp.UtcTicks);
+	Write(Timestamp.Frame);
+	Write(Timestamp.Seconds);
+	Write(Timestamp.Timecode.Hours);
+	Write(Timestamp.Timecode.Minutes);
+	Write(Timestamp.Timecode.Seconds);
+	Write(Timestamp.Timecode.Frames);
+	Write(static_cast<uint8>(Timestamp.Timecode.bDropFrameFormat));
+	Write(Timestamp.Type);
+	Write(static_cast<uint8>(Timestamp.bIncludeFrame));
+}
+
+void FBlueprintMessageBinarySink::Submit()
+{
+	if (Buffer.IsEmpty() || !FileHandle.IsValid())
+	{
+		return;
+	}
+
+	WritePipe.Launch(UE_SOURCE_LOCATION, [Handle = FileHandle.Get(), Data = MoveTemp(Buffer)]()
+	{
+		Handle->Write(Data.GetData(), Data.Num());
+	});
+
+	Buffer.Reset(BufferSize);
+}
+
+void FBlueprintMessageBinarySink::Flush()
+{
+	Submit();
+
+	if (FileHandle.IsValid())
+	{
+		WritePipe.Launch(UE_SOURCE_LOCATION, [Handle = FileHandle.Get()]()
+		{
+			Handle->Flush();
+		});
+	}
+}
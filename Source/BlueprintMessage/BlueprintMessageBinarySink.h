@@ -0,0 +1,80 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlueprintMessageSink.h"
+#include "BlueprintMessageBinaryReader.h"
+#include "Tasks/Pipe.h"
+
+class IFileHandle;
+
+/**
+ * Sink writing shown messages to append-only binary file preserving token structure.
+ *
+ * Category names, paths and format patterns are written once to string table, records refer to them by id.
+ * Token text is mostly unique and is written inline with its record.
+ * Format text and timestamp tokens are stored as pattern with argument values and captured time, formatted by reader.
+ * Records are accumulated in memory and written by background task in order.
+ *
+ * String table belongs to the file, so each run starts a new file. File left by previous run
+ * is renamed to "<Name>-backup-<timestamp>.bpmlog" next to it.
+ *
+ * @see BlueprintMessageBinaryFormat
+ */
+class BLUEPRINTMESSAGE_API FBlueprintMessageBinarySink : public IBlueprintMessageSink
+{
+public:
+	/**
+	 * @param InFilePath path to write messages to, relative paths are resolved against project log directory
+	 * @param InBufferSize number of bytes accumulated before write is issued
+	 */
+	explicit FBlueprintMessageBinarySink(const FString& InFilePath, int32 InBufferSize = 64 * 1024);
+	virtual ~FBlueprintMessageBinarySink() override;
+
+	//~ Begin IBlueprintMessageSink Interface
+	virtual void ReceiveMessage(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage) override;
+	virtual void Flush() override;
+	//~ End IBlueprintMessageSink Interface
+
+	/** Is sink file opened */
+	bool IsOpen() const { return FileHandle.IsValid(); }
+
+private:
+	uint32 GetStringId(const FString& InString);
+	uint32 GetStringId(const FName& InName);
+	uint32 WriteString(const FString& InString);
+	/* Write length prefixed UTF-8 text */
+	void WriteText(const FString& InString);
+
+	/* Resolve string ids of token payload, writing new strings to stream */
+	void ResolveToken(const TSharedRef<IMessageToken>& InToken, FBlueprintMessageBinaryToken& OutRecord);
+	void ResolveFormatToken(const class FBlueprintMessageFormatToken& InToken, FBlueprintMessageBinaryToken& OutRecord);
+	void ResolveTimestampToken(const class FBlueprintMessageTimestampToken& InToken, FBlueprintMessageBinaryToken& OutRecord);
+	void WriteToken(const IMessageToken& InToken, const FBlueprintMessageBinaryToken& InRecord);
+	void WriteFormatToken(const class FBlueprintMessageFormatToken& InToken, const FBlueprintMessageBinaryToken& InRecord);
+	void WriteTimestampToken(const FBlueprintMessageBinaryToken& InRecord);
+
+	template<typename T>
+	void Write(const T& Value)
+	{
+		Buffer.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+	}
+
+	/* Issue background write of accumulated buffer */
+	void Submit();
+
+	TUniquePtr<IFileHandle> FileHandle;
+	/* Serializes background writes */
+	UE::Tasks::FPipe WritePipe;
+
+	TArray<uint8> Buffer;
+	int32 BufferSize;
+
+	TMap<FString, uint32> StringIds;
+	TMap<FName, uint32> NameIds;
+	uint32 NextStringId = 0;
+
+	/* Resolved tokens of message being written, reused between messages */
+	TArray<FBlueprintMessageBinaryToken> TokenRecords;
+};
@@ -0,0 +1,128 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageBuilder.h"
+#include "BlueprintMessage.h"
+#include "BlueprintMessageSettings.h"
+#include "BlueprintMessageCategoryGate.h"
+
+FBlueprintMessageBuilder::FBlueprintMessageBuilder(FName InCategory, EBlueprintMessageSeverity InSeverity, const FText& InMessage)
+	: Category(InCategory), Severity(InSeverity), InitialMessage(InMessage)
+{
+	bSuppressLoggingToOutputLog = UBlueprintMessageSettings::Get()->bDefaultSuppressLoggingToOutputLog;
+	bOutputLogFromSettings = false;
+}
+
+FBlueprintMessageBuilder& FBlueprintMessageBuilder::AddToken(const FBlueprintMessageToken& Token, FName Slot)
+{
+	if (Slot.IsNone())
+	{
+		Tokens.Add(Token);
+		return *this;
+	}
+
+	bool bAnythingSet = false;
+	for (FBlueprintMessageToken& Item : Tokens)
+	{
+		if (Item.Name == Slot)
+		{
+			Item.SetContent(Token);
+			bAnythingSet = true;
+		}
+	}
+
+	if (!bAnythingSet)
+	{
+		Tokens.Add_GetRef(Token).Name = Slot;
+	}
+	return *this;
+}
+
+FBlueprintMessageBuilder& FBlueprintMessageBuilder::AddToken(FBlueprintMessageToken&& Token)
+{
+	Tokens.Add(MoveTemp(Token));
+	return *this;
+}
+
+FBlueprintMessageBuilder& FBlueprintMessageBuilder::AddTokens(const TArray<FBlueprintMessageToken>& InTokens)
+{
+	Tokens.Append(InTokens);
+	return *this;
+}
+
+FBlueprintMessageBuilder& FBlueprintMessageBuilder::AddNamedSlot(FName Name)
+{
+	Tokens.Add(FBlueprintMessageToken(Name));
+	return *this;
+}
+
+FBlueprintMessageBuilder& FBlueprintMessageBuilder::SetSeverity(EBlueprintMessageSeverity InSeverity)
+{
+	Severity = InSeverity;
+	return *this;
+}
+
+FBlueprintMessageBuilder& FBlueprintMessageBuilder::SetCallSiteId(uint32 InCallSiteId)
+{
+	CallSiteId = InCallSiteId;
+	return *this;
+}
+
+void FBlueprintMessageBuilder::Show() const
+{
+	if (!UBlueprintMessage::HasMessageConsumers())
+	{
+		return;
+	}
+
+	// default constructed builders take project settings only now, struct construction stays free of settings access
+	const FName ShowCategory = Category.IsNone() ? UBlueprintMessageSettings::Get()->GetDefaultCategory() : Category;
+	const bool bSuppressOutputLog = bSuppressLoggingToOutputLog || (bOutputLogFromSettings && UBlueprintMessageSettings::Get()->bDefaultSuppressLoggingToOutputLog);
+
+	if (!FBlueprintMessageCategoryGate::IsEnabled(ShowCategory, Severity)
+		|| UBlueprintMessage::IsRepeatSuppressed(ShowCategory, Severity, InitialMessage, Tokens, bSuppressOutputLog, CallSiteId))
+	{
+		return;
+	}
+
+	UBlueprintMessage::FTagToMessage TagToMessage = UBlueprintMessage::BuildMessage(ShowCategory, Severity, InitialMessage, Tokens);
+	UBlueprintMessage::ShowImpl(TagToMessage.Key, TagToMessage.Value, bSuppressOutputLog, CallSiteId);
+}
+
+void FBlueprintMessageBuilder::Reset()
+{
+	Category = NAME_None;
+	Severity = EBlueprintMessageSeverity::Info;
+	InitialMessage = FText::GetEmpty();
+	CallSiteId = 0;
+	Tokens.Reset();
+	bSuppressLoggingToOutputLog = false;
+	bOutputLogFromSettings = true;
+}
+
+FBlueprintMessageBuilder UBlueprintMessageBuilderLibrary::MakeMessageBuilder(FName LogCategory, EBlueprintMessageSeverity Severity, FText Message)
+{
+	return FBlueprintMessageBuilder(LogCategory, Severity, Message);
+}
+
+void UBlueprintMessageBuilderLibrary::BuilderAddToken(FBlueprintMessageBuilder& Builder, const FBlueprintMessageToken& Token, FName Slot)
+{
+	Builder.AddToken(Token, Slot);
+}
+
+void UBlueprintMessageBuilderLibrary::BuilderAddTokens(FBlueprintMessageBuilder& Builder, const TArray<FBlueprintMessageToken>& Tokens)
+{
+	Builder.AddTokens(Tokens);
+}
+
+void UBlueprintMessageBuilderLibrary::BuilderShow(const FBlueprintMessageBuilder& Builder)
+{
+	Builder.Show();
+}
+
+void UBlueprintMessageBuilderLibrary::ShowBlueprintMessage(FName LogCategory, EBlueprintMessageSeverity Severity, const TArray<FBlueprintMessageToken>& Tokens, int32 CallSiteId)
+{
+	FBlueprintMessageBuilder Builder(LogCategory, Severity);
+	Builder.AddTokens(Tokens);
+	Builder.SetCallSiteId(static_cast<uint32>(CallSiteId));
+	Builder.Show();
+}
@@ -0,0 +1,124 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlueprintMessageToken.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "BlueprintMessageBuilder.generated.h"
+
+/**
+ * Value-type message builder.
+ *
+ * Holds the same state as UBlueprintMessage but lives on stack or in a blueprint local variable,
+ * allowing to build and show short-living messages without constructing any UObject.
+ *
+ * Builder can be shown from any thread, messages from worker threads are delivered on game thread.
+ */
+USTRUCT(BlueprintType, Category="Utilities|MessageLog")
+struct BLUEPRINTMESSAGE_API FBlueprintMessageBuilder
+{
+	GENERATED_BODY()
+public:
+	/** Message in default category, category and output log setting are resolved from project settings when shown */
+	FBlueprintMessageBuilder() = default;
+	/** Message in given category with output log setting taken from project settings */
+	explicit FBlueprintMessageBuilder(FName InCategory, EBlueprintMessageSeverity InSeverity = EBlueprintMessageSeverity::Info, const FText& InMessage = FText::GetEmpty());
+
+	/** Add token to this message, token with slot name replaces matching slots */
+	FBlueprintMessageBuilder& AddToken(const FBlueprintMessageToken& Token, FName Slot = NAME_None);
+	/** Add token to this message */
+	FBlueprintMessageBuilder& AddToken(FBlueprintMessageToken&& Token);
+	/** Add multiple tokens to this message */
+	FBlueprintMessageBuilder& AddTokens(const TArray<FBlueprintMessageToken>& InTokens);
+	/** Add a token slot with name */
+	FBlueprintMessageBuilder& AddNamedSlot(FName Name);
+	/** Change severity for this message */
+	FBlueprintMessageBuilder& SetSeverity(EBlueprintMessageSeverity InSeverity);
+	/** Set id of blueprint node that produced this message */
+	FBlueprintMessageBuilder& SetCallSiteId(uint32 InCallSiteId);
+
+	/** Show message in Message Log */
+	void Show() const;
+
+	/** Reset builder to default constructed state, keeping token storage */
+	void Reset();
+
+	/** Category of this message, None for project default category */
+	FName GetCategory() const { return Category; }
+	EBlueprintMessageSeverity GetSeverity() const { return Severity; }
+	uint32 GetCallSiteId() const { return CallSiteId; }
+	const TArray<FBlueprintMessageToken>& GetTokens() const { return Tokens; }
+
+protected:
+	UPROPERTY()
+	FName Category;
+
+	UPROPERTY()
+	EBlueprintMessageSeverity Severity = EBlueprintMessageSeverity::Info;
+
+	UPROPERTY()
+	FText InitialMessage;
+
+	/** Stream of tokens for this message */
+	UPROPERTY()
+	TArray<FBlueprintMessageToken> Tokens;
+
+	/* Id of blueprint node that produced this message, 0 if unknown */
+	uint32 CallSiteId = 0;
+
+	/* Project default output log setting applies when shown, builder was not constructed with explicit settings */
+	bool bOutputLogFromSettings = true;
+
+public:
+	/**
+	 * Should we mirror message log messages from this builder to the output log?
+	 * Default constructed builders are also suppressed when project default suppresses output log.
+	 */
+	UPROPERTY(BlueprintReadWrite, Category=Message)
+	bool bSuppressLoggingToOutputLog = false;
+};
+
+/**
+ * Blueprint access to value-type message builder.
+ */
+UCLASS()
+class BLUEPRINTMESSAGE_API UBlueprintMessageBuilderLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+public:
+
+	/**
+	 * Construct new message builder.
+	 *
+	 * @param LogCategory message log category for this message
+	 * @param Severity severity of this message
+	 * @param Message initial message text
+	 * @returns builder value
+	 */
+	UFUNCTION(BlueprintPure, DisplayName="Make Log Message Builder", Category="Utilities|MessageLog|Builder", meta=(AdvancedDisplay=2, Keywords="create message builder"))
+	static UPARAM(DisplayName="Builder") FBlueprintMessageBuilder MakeMessageBuilder(
+		UPARAM(DisplayName="Category", meta=(GetOptions="BlueprintMessage.BlueprintMessageLibrary.GetAvailableCategories")) FName LogCategory = TEXT("BlueprintLog"),
+		EBlueprintMessageSeverity Severity = EBlueprintMessageSeverity::Info,
+		FText Message = INVTEXT(""));
+
+	/** Add token to message builder */
+	UFUNCTION(BlueprintCallable, DisplayName="Add Token (Builder)", Category="Utilities|MessageLog|Builder", meta=(AutoCreateRefTerm="Token"))
+	static void BuilderAddToken(UPARAM(ref) FBlueprintMessageBuilder& Builder, const FBlueprintMessageToken& Token, FName Slot = NAME_None);
+
+	/** Add multiple tokens to message builder */
+	UFUNCTION(BlueprintCallable, DisplayName="Add Tokens (Builder)", Category="Utilities|MessageLog|Builder", meta=(AutoCreateRefTerm="Tokens"))
+	static void BuilderAddTokens(UPARAM(ref) FBlueprintMessageBuilder& Builder, const TArray<FBlueprintMessageToken>& Tokens);
+
+	/** Show message builder contents in Message Log */
+	UFUNCTION(BlueprintCallable, DisplayName="Show (Builder)", Category="Utilities|MessageLog|Builder")
+	static void BuilderShow(const FBlueprintMessageBuilder& Builder);
+
+	/**
+	 * Build and show message without constructing message object.
+	 *
+	 * Used by Create Log Message node when message never leaves the execution chain.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Utilities|MessageLog|Builder", meta=(BlueprintInternalUseOnly=true, AutoCreateRefTerm="Tokens"))
+	static void ShowBlueprintMessage(FName LogCategory, EBlueprintMessageSeverity Severity, const TArray<FBlueprintMessageToken>& Tokens, int32 CallSiteId = 0);
+};
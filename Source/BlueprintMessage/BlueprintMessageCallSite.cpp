@@ -0,0 +1,74 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageCallSite.h"
+#include "BlueprintMessage.h"
+#include "Misc/ScopeRWLock.h"
+
+FBlueprintMessageCallSiteRegistry* FBlueprintMessageCallSiteRegistry::Instance = nullptr;
+
+FBlueprintMessageCallSiteRegistry::FBlueprintMessageCallSiteRegistry()
+{
+	check(Instance == nullptr);
+	Instance = this;
+}
+
+FBlueprintMessageCallSiteRegistry::~FBlueprintMessageCallSiteRegistry()
+{
+	check(Instance == this);
+	Instance = nullptr;
+}
+
+uint32 FBlueprintMessageCallSiteRegistry::MakeId(const FSoftObjectPath& InBlueprint, const FGuid& InNodeGuid)
+{
+	// hash path string rather than names, name hashes depend on name table order and differ between sessions
+	const uint32 Id = HashCombine(GetTypeHash(InBlueprint.ToString()), GetTypeHash(InNodeGuid));
+	return Id != 0 ? Id : 1;
+}
+
+uint32 FBlueprintMessageCallSiteRegistry::Register(const FSoftObjectPath& InBlueprint, const FGuid& InNodeGuid, const FString& InNodePath)
+{
+	const uint32 Id = MakeId(InBlueprint, InNodeGuid);
+
+	FWriteScopeLock ScopeLock(Lock);
+
+	if (FBlueprintMessageCallSite* Existing = CallSites.Find(Id))
+	{
+		if (Existing->Blueprint != InBlueprint || Existing->NodeGuid != InNodeGuid)
+		{
+			UE_LOG(LogBlueprintMessage, Warning, TEXT("Message call site %s has same id %08x as %s"), *InNodePath, Id, *Existing->NodePath);
+			return Id;
+		}
+		// node may be renamed or moved between graphs
+		Existing->NodePath = InNodePath;
+		return Id;
+	}
+
+	CallSites.Add(Id, FBlueprintMessageCallSite { InBlueprint, InNodeGuid, InNodePath });
+	return Id;
+}
+
+bool FBlueprintMessageCallSiteRegistry::Find(uint32 InId, FBlueprintMessageCallSite& OutCallSite) const
+{
+	FReadScopeLock ScopeLock(Lock);
+
+	if (const FBlueprintMessageCallSite* CallSite = CallSites.Find(InId))
+	{
+		OutCallSite = *CallSite;
+		return true;
+	}
+	return false;
+}
+
+FString FBlueprintMessageCallSiteRegistry::GetNodePath(uint32 InId) const
+{
+	FReadScopeLock ScopeLock(Lock);
+
+	const FBlueprintMessageCallSite* CallSite = CallSites.Find(InId);
+	return CallSite ? CallSite->NodePath : FString();
+}
+
+int32 FBlueprintMessageCallSiteRegistry::Num() const
+{
+	FReadScopeLock ScopeLock(Lock);
+	return CallSites.Num();
+}
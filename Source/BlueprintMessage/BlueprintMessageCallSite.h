@@ -0,0 +1,68 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+
+/**
+ * Blueprint node that produced a message.
+ */
+struct FBlueprintMessageCallSite
+{
+	/* Blueprint owning the node */
+	FSoftObjectPath Blueprint;
+	/* Guid of node in blueprint graph */
+	FGuid NodeGuid;
+	/* Full path of node object */
+	FString NodePath;
+};
+
+/**
+ * Registry of blueprint call sites stamped on messages.
+ *
+ * Create Message and Add Token nodes stamp messages with a compact id derived from owning blueprint and node guid,
+ * so per-site statistics, deduplication or sampling can work with an integer instead of strings.
+ * Ids are stable between sessions, 0 means unknown call site.
+ *
+ * Nodes register themselves when blueprint is compiled, so ids resolve to node paths in editor
+ * for blueprints compiled in current session. Packaged builds only carry ids.
+ *
+ * Instance is owned by the module, lookups can be done from any thread.
+ */
+class BLUEPRINTMESSAGE_API FBlueprintMessageCallSiteRegistry
+{
+public:
+	FBlueprintMessageCallSiteRegistry();
+	~FBlueprintMessageCallSiteRegistry();
+
+	/** Get registry instance, null if module is not loaded */
+	static FBlueprintMessageCallSiteRegistry* Get() { return Instance; }
+
+	/** Compute call site id of node, never 0 */
+	static uint32 MakeId(const FSoftObjectPath& InBlueprint, const FGuid& InNodeGuid);
+
+	/**
+	 * Register call site and get its id.
+	 * @param InBlueprint blueprint owning the node
+	 * @param InNodeGuid guid of node
+	 * @param InNodePath full path of node object
+	 * @returns call site id
+	 */
+	uint32 Register(const FSoftObjectPath& InBlueprint, const FGuid& InNodeGuid, const FString& InNodePath);
+
+	/** Find registered call site by id */
+	bool Find(uint32 InId, FBlueprintMessageCallSite& OutCallSite) const;
+
+	/** Get path of node registered with id, empty if not registered */
+	FString GetNodePath(uint32 InId) const;
+
+	/** Number of registered call sites */
+	int32 Num() const;
+
+private:
+	static FBlueprintMessageCallSiteRegistry* Instance;
+
+	mutable FRWLock Lock;
+	TMap<uint32, FBlueprintMessageCallSite> CallSites;
+};
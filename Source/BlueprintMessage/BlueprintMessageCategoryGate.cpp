@@ -0,0 +1,153 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageCategoryGate.h"
+#include "BlueprintMessageSettings.h"
+#include "HAL/IConsoleManager.h"
+
+namespace BlueprintMessageCategoryGate
+{
+	constexpr int32 MaxLevel = static_cast<int32>(EBlueprintMessageSeverity::Info);
+
+	TAutoConsoleVariable<int32> CVarMinSeverity(
+		TEXT("BlueprintMessage.MinSeverity"),
+		MaxLevel,
+		TEXT("Least severe blueprint message level shown in all categories.\n")
+		TEXT("0 - disable all, 1 - Error, 2 - PerformanceWarning, 3 - Warning, 4 - Info (default)"),
+		ECVF_Default);
+
+	void OnVariablesChanged()
+	{
+		if (FBlueprintMessageCategoryGate* Gate = FBlueprintMessageCategoryGate::Get())
+		{
+			Gate->Refresh();
+		}
+	}
+
+	// sink is called once on game thread after any variables changed
+	FAutoConsoleVariableSink CVarSink(FConsoleCommandDelegate::CreateStatic(&OnVariablesChanged));
+}
+
+FBlueprintMessageCategoryGate* FBlueprintMessageCategoryGate::Instance = nullptr;
+
+FBlueprintMessageCategoryGate::FBlueprintMessageCategoryGate()
+{
+	check(Instance == nullptr);
+	Instance = this;
+
+	RegisterCategoryVariables();
+	Refresh();
+}
+
+FBlueprintMessageCategoryGate::~FBlueprintMessageCategoryGate()
+{
+	check(Instance == this);
+
+	for (IConsoleVariable* Variable : HandleVariables)
+	{
+		if (Variable)
+		{
+			IConsoleManager::Get().UnregisterConsoleObject(Variable);
+		}
+	}
+	HandleVariables.Empty();
+
+	Instance = nullptr;
+}
+
+void FBlueprintMessageCategoryGate::RegisterCategoryVariables()
+{
+	const UBlueprintMessageSettings* Settings = UBlueprintMessageSettings::Get();
+
+	TArray<FName, TInlineAllocator<16>> Categories;
+	Categories.AddUnique(Settings->GetDefaultCategory());
+	Categories.AddUnique(TEXT("BlueprintLog"));
+	for (const FBlueprintMessageLogCategory& Category : Settings->CustomCategories)
+	{
+		if (!Category.Name.IsNone())
+		{
+			Categories.AddUnique(Category.Name);
+		}
+	}
+
+	// handle 0 is shared by categories without own variable
+	HandleVariables.Add(nullptr);
+
+	for (const FName& Category : Categories)
+	{
+		const FString Name = FString::Printf(TEXT("BlueprintMessage.Category.%s"), *Category.ToString());
+		if (IConsoleManager::Get().FindConsoleVariable(*Name))
+		{
+			continue;
+		}
+
+		IConsoleVariable* Variable = IConsoleManager::Get().RegisterConsoleVariable(*Name, -1,
+			*FString::Printf(TEXT("Least severe blueprint message level shown in %s category, -1 follows BlueprintMessage.MinSeverity"), *Category.ToString()),
+			ECVF_Default);
+		CategoryHandles.Add(Category, HandleVariables.Add(Variable));
+	}
+
+	DefaultCategoryHandle = FindCategoryHandle(Settings->GetDefaultCategory());
+	Masks = MakeUnique<std::atomic<uint8>[]>(HandleVariables.Num());
+}
+
+uint8 FBlueprintMessageCategoryGate::MakeMask(int32 InLevel)
+{
+	// severity bits up to and including level, critical errors are shown with errors
+	const int32 Level = FMath::Min(InLevel, BlueprintMessageCategoryGate::MaxLevel);
+	return Level > 0 ? static_cast<uint8>((1u << (Level + 1)) - 1) : 0;
+}
+
+void FBlueprintMessageCategoryGate::Refresh()
+{
+	const int32 GlobalLevel = BlueprintMessageCategoryGate::CVarMinSeverity.GetValueOnAnyThread();
+	const uint8 AllMask = MakeMask(BlueprintMessageCategoryGate::MaxLevel);
+
+	bool bNothingDisabled = true;
+	for (int32 Handle = 0; Handle < HandleVariables.Num(); ++Handle)
+	{
+		const int32 Level = HandleVariables[Handle] ? HandleVariables[Handle]->GetInt() : -1;
+		const uint8 Mask = MakeMask(Level < 0 ? GlobalLevel : Level);
+		Masks[Handle].store(Mask, std::memory_order_relaxed);
+		bNothingDisabled &= Mask == AllMask;
+	}
+
+	bAllEnabled.store(bNothingDisabled, std::memory_order_relaxed);
+}
+
+int32 FBlueprintMessageCategoryGate::FindCategoryHandle(const FName& InCategory) const
+{
+	if (InCategory.IsNone())
+	{
+		return DefaultCategoryHandle;
+	}
+	const int32* Handle = CategoryHandles.Find(InCategory);
+	return Handle ? *Handle : 0;
+}
+
+int32 FBlueprintMessageCategoryGate::GetCategoryHandle(const FName& InCategory)
+{
+	return Instance ? Instance->FindCategoryHandle(InCategory) : 0;
+}
+
+bool FBlueprintMessageCategoryGate::IsEnabled(const FName& InCategory, EBlueprintMessageSeverity InSeverity)
+{
+	return !Instance || Instance->bAllEnabled.load(std::memory_order_relaxed)
+		|| Instance->IsEnabledImpl(Instance->FindCategoryHandle(InCategory), InSeverity);
+}
+
+bool FBlueprintMessageCategoryGate::IsEnabled(int32 InCategoryHandle, EBlueprintMessageSeverity InSeverity)
+{
+	return !Instance || Instance->IsEnabledImpl(InCategoryHandle, InSeverity);
+}
+
+bool FBlueprintMessageCategoryGate::IsEnabledImpl(int32 InCategoryHandle, EBlueprintMessageSeverity InSeverity) const
+{
+	if (bAllEnabled.load(std::memory_order_relaxed))
+	{
+		return true;
+	}
+
+	const uint8 Bit = static_cast<uint8>(1u << static_cast<uint8>(InSeverity));
+	const int32 Handle = InCategoryHandle >= 0 && InCategoryHandle < HandleVariables.Num() ? InCategoryHandle : 0;
+	return (Masks[Handle].load(std::memory_order_relaxed) & Bit) != 0;
+}
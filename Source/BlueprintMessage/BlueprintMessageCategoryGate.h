@@ -0,0 +1,70 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlueprintMessageToken.h"
+#include <atomic>
+
+struct IConsoleVariable;
+
+/**
+ * Runtime switch of message categories.
+ *
+ * Every category known from settings gets a handle indexing a precomputed array of severity
+ * bitmasks, handle 0 is used by categories without own console variable and follows global mask.
+ * Handles are assigned once on creation and masks are atomics, so lookups take no lock.
+ * Blueprint nodes branch on the gate before message object and tokens are built, so disabled
+ * messages cost a single lookup.
+ *
+ * Masks are driven by console variables:
+ *  BlueprintMessage.MinSeverity - least severe level shown in all categories
+ *  BlueprintMessage.Category.<Name> - override for configured category, -1 follows global value
+ * Levels are 0 to disable, 1 Error, 2 PerformanceWarning, 3 Warning, 4 Info.
+ *
+ * Instance is owned by the module, lookups can be done from any thread.
+ */
+class BLUEPRINTMESSAGE_API FBlueprintMessageCategoryGate
+{
+public:
+	FBlueprintMessageCategoryGate();
+	~FBlueprintMessageCategoryGate();
+
+	/** Get gate instance, null if module is not loaded */
+	static FBlueprintMessageCategoryGate* Get() { return Instance; }
+
+	/** Is message of category and severity going to be shown, true if module is not loaded */
+	static bool IsEnabled(const FName& InCategory, EBlueprintMessageSeverity InSeverity);
+
+	/** Is message of category handle and severity going to be shown, true if module is not loaded */
+	static bool IsEnabled(int32 InCategoryHandle, EBlueprintMessageSeverity InSeverity);
+
+	/** Get handle of category for repeated lookups, 0 for categories without own variable */
+	static int32 GetCategoryHandle(const FName& InCategory);
+
+	/** Rebuild category masks from console variables */
+	void Refresh();
+
+private:
+	bool IsEnabledImpl(int32 InCategoryHandle, EBlueprintMessageSeverity InSeverity) const;
+
+	int32 FindCategoryHandle(const FName& InCategory) const;
+
+	/* Register console variable and assign handle for each category known from settings */
+	void RegisterCategoryVariables();
+
+	static uint8 MakeMask(int32 InLevel);
+
+	static FBlueprintMessageCategoryGate* Instance;
+
+	/* Category handles, immutable after construction */
+	TMap<FName, int32> CategoryHandles;
+	/* Handle of default category used for messages without category */
+	int32 DefaultCategoryHandle = 0;
+	/* Console variable by handle, null for handle 0 */
+	TArray<IConsoleVariable*> HandleVariables;
+	/* Enabled severities by handle */
+	TUniquePtr<std::atomic<uint8>[]> Masks;
+	/* Fast path when nothing is disabled */
+	std::atomic<bool> bAllEnabled = true;
+};
@@ -0,0 +1,85 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageFormatToken.h"
+#include "Internationalization/TextFormatter.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/ScopeRWLock.h"
+#include "Hash/CityHash.h"
+
+namespace BlueprintMessageFormatToken
+{
+	/* Live format tokens, engine tokens carry no type information to cast with */
+	FRWLock InstancesLock;
+	TSet<const IMessageToken*> Instances;
+}
+
+FBlueprintMessageFormatToken::FBlueprintMessageFormatToken(FText&& InPattern, TArray<FFormatArgumentData>&& InArguments)
+	: Pattern(MoveTemp(InPattern))
+	, Arguments(MoveTemp(InArguments))
+{
+	auto HashString = [this](const FString& InString)
+	{
+		ContentHash = CityHash64WithSeed(reinterpret_cast<const char*>(*InString), InString.Len() * sizeof(TCHAR), ContentHash);
+	};
+	auto HashValue = [this](const auto& InValue)
+	{
+		ContentHash = CityHash64WithSeed(reinterpret_cast<const char*>(&InValue), sizeof(InValue), ContentHash);
+	};
+
+	HashString(Pattern.ToString());
+	for (const FFormatArgumentData& Argument : Arguments)
+	{
+		HashString(Argument.ArgumentName);
+		HashValue(Argument.ArgumentValueType);
+		switch (Argument.ArgumentValueType)
+		{
+		case EFormatArgumentType::Text:
+			HashString(Argument.ArgumentValue.ToString());
+			break;
+		case EFormatArgumentType::Gender:
+			HashValue(Argument.ArgumentValueGender);
+			break;
+		default:
+			HashValue(Argument.ArgumentValueInt);
+			HashValue(Argument.ArgumentValueFloat);
+			HashValue(Argument.ArgumentValueDouble);
+			break;
+		}
+	}
+
+	FWriteScopeLock Lock(BlueprintMessageFormatToken::InstancesLock);
+	BlueprintMessageFormatToken::Instances.Add(this);
+}
+
+FBlueprintMessageFormatToken::~FBlueprintMessageFormatToken()
+{
+	FWriteScopeLock Lock(BlueprintMessageFormatToken::InstancesLock);
+	BlueprintMessageFormatToken::Instances.Remove(this);
+}
+
+const FBlueprintMessageFormatToken* FBlueprintMessageFormatToken::Cast(const IMessageToken& InToken)
+{
+	if (InToken.GetType() != EMessageToken::Text)
+	{
+		return nullptr;
+	}
+	FReadScopeLock Lock(BlueprintMessageFormatToken::InstancesLock);
+	return BlueprintMessageFormatToken::Instances.Contains(&InToken) ? static_cast<const FBlueprintMessageFormatToken*>(&InToken) : nullptr;
+}
+
+TSharedRef<FBlueprintMessageFormatToken> FBlueprintMessageFormatToken::Create(FText InPattern, TArray<FFormatArgumentData>&& InArguments)
+{
+	return MakeShareable(new FBlueprintMessageFormatToken(MoveTemp(InPattern), MoveTemp(InArguments)));
+}
+
+const FText& FBlueprintMessageFormatToken::ToText() const
+{
+	FScopeLock Lock(&FormatLock);
+	if (!bFormatted)
+	{
+		// same formatting path as UKismetTextLibrary::Format
+		const_cast<FBlueprintMessageFormatToken*>(this)->CachedText = FTextFormatter::Format(FTextFormat(Pattern), CopyTemp(Arguments), false, false);
+		bFormatted = true;
+	}
+	return CachedText;
+}
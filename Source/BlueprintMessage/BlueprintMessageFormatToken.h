@@ -0,0 +1,51 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Logging/TokenizedMessage.h"
+
+/**
+ * Text token holding format pattern and captured argument values, formatted only when rendered.
+ *
+ * Messages filtered out before display or consumed by sinks that do not render text never pay for FText::Format.
+ */
+class BLUEPRINTMESSAGE_API FBlueprintMessageFormatToken : public IMessageToken
+{
+public:
+	/** Create token from pattern and argument values, arguments are taken over */
+	static TSharedRef<FBlueprintMessageFormatToken> Create(FText InPattern, TArray<FFormatArgumentData>&& InArguments);
+
+	/** Format token behind engine token, nullptr if token is of other type */
+	static const FBlueprintMessageFormatToken* Cast(const IMessageToken& InToken);
+
+	virtual ~FBlueprintMessageFormatToken() override;
+
+	//~ Begin IMessageToken Interface
+	virtual EMessageToken::Type GetType() const override { return EMessageToken::Text; }
+	virtual const FText& ToText() const override;
+	//~ End IMessageToken Interface
+
+	/** Has text been formatted already */
+	bool IsFormatted() const { return bFormatted; }
+
+	/** Hash of pattern and argument values, computed on creation without formatting */
+	uint64 GetContentHash() const { return ContentHash; }
+
+	/** Format pattern */
+	const FText& GetPattern() const { return Pattern; }
+
+	/** Captured argument values, kept after formatting for sinks storing them unformatted */
+	const TArray<FFormatArgumentData>& GetArguments() const { return Arguments; }
+
+private:
+	FBlueprintMessageFormatToken(FText&& InPattern, TArray<FFormatArgumentData>&& InArguments);
+
+	FText Pattern;
+	uint64 ContentHash = 0;
+	TArray<FFormatArgumentData> Arguments;
+
+	/* Guards lazy formatting, token may be rendered by several sinks */
+	mutable FCriticalSection FormatLock;
+	mutable bool bFormatted = false;
+};
@@ -0,0 +1,200 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageHistory.h"
+#include "BlueprintMessageHistoryIndex.h"
+#include "BlueprintMessage.h"
+
+FBlueprintMessageHistory* FBlueprintMessageHistory::Instance = nullptr;
+
+FBlueprintMessageHistory::FBlueprintMessageHistory(int32 InCapacity, bool bInWithIndex)
+{
+	check(Instance == nullptr);
+	Instance = this;
+
+	Records.SetNum(FMath::Max(InCapacity, 1));
+	AnchorTicks = FDateTime::UtcNow().GetTicks();
+	AnchorCycles = FPlatformTime::Cycles64();
+	if (bInWithIndex)
+	{
+		Index = MakeUnique<FBlueprintMessageHistoryIndex>(*this);
+	}
+}
+
+FBlueprintMessageHistory::~FBlueprintMessageHistory()
+{
+	check(Instance == this);
+	Instance = nullptr;
+}
+
+void FBlueprintMessageHistory::FSequenceList::Trim(uint64 InOldest)
+{
+	while (Head < Sequences.Num() && Sequences[Head] < InOldest)
+	{
+		++Head;
+	}
+	// compact once evicted part dominates to keep memory bounded
+	if (Head > 32 && Head * 2 > Sequences.Num())
+	{
+		Sequences.RemoveAt(0, Head);
+		Head = 0;
+	}
+}
+
+void FBlueprintMessageHistory::ReceiveMessage(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage)
+{
+	check(IsInGameThread());
+
+	const uint64 Sequence = NextSequence++;
+	const EMessageSeverity::Type Severity = FMath::Min(InMessage->GetSeverity(), EMessageSeverity::Info);
+
+	FRecord& Record = Records[Sequence % Records.Num()];
+	Record.Sequence = Sequence;
+	Record.Ticks = FDateTime::UtcNow().GetTicks();
+	Record.Cycles = FPlatformTime::Cycles64();
+	Record.Category = InCategory;
+	Record.Severity = Severity;
+	Record.Message = InMessage;
+
+	const uint64 Oldest = GetOldestSequence();
+
+	FSequenceList& CategoryList = ByCategory.FindOrAdd(TPair<FName, uint8>(InCategory, static_cast<uint8>(Severity)));
+	CategoryList.Trim(Oldest);
+	CategoryList.Add(Sequence);
+
+	FSequenceList& SeverityList = BySeverity[Severity];
+	SeverityList.Trim(Oldest);
+	SeverityList.Add(Sequence);
+
+	if (Index.IsValid())
+	{
+		Index->AddRecord(Record);
+	}
+}
+
+uint64 FBlueprintMessageHistory::TicksToCycles(int64 InTicks) const
+{
+	if (InTicks == MIN_int64)
+	{
+		return 0;
+	}
+	if (InTicks == MAX_int64)
+	{
+		return MAX_uint64;
+	}
+	const double Seconds = (static_cast<double>(InTicks) - static_cast<double>(AnchorTicks)) / ETimespan::TicksPerSecond;
+	const double Cycles = static_cast<double>(AnchorCycles) + Seconds / FPlatformTime::GetSecondsPerCycle64();
+	return Cycles <= 0.0 ? 0 : Cycles >= static_cast<double>(MAX_uint64) ? MAX_uint64 : static_cast<uint64>(Cycles);
+}
+
+const FBlueprintMessageHistory::FRecord* FBlueprintMessageHistory::FindRecord(uint64 InSequence) const
+{
+	return InSequence >= GetOldestSequence() && InSequence < NextSequence ? &GetRecord(InSequence) : nullptr;
+}
+
+void FBlueprintMessageHistory::Query(const FQuery& InQuery, TFunctionRef<void(const FRecord&)> InVisitor) const
+{
+	check(IsInGameThread());
+
+	const uint64 Oldest = GetOldestSequence();
+	const uint64 StartCycles = TicksToCycles(InQuery.StartTicks);
+	const uint64 EndCycles = TicksToCycles(InQuery.EndTicks);
+
+	// collect index lists matching category and severity
+	TArray<FSequenceList*, TInlineAllocator<EMessageSeverity::Info + 1>> Lists;
+	for (int32 Severity = 0; Severity <= FMath::Min<int32>(InQuery.Severity, EMessageSeverity::Info); ++Severity)
+	{
+		FSequenceList* List = InQuery.Category.IsNone()
+			? &BySeverity[Severity]
+			: ByCategory.Find(TPair<FName, uint8>(InQuery.Category, static_cast<uint8>(Severity)));
+		if (List)
+		{
+			List->Trim(Oldest);
+			if (!List->IsEmpty())
+			{
+				Lists.Add(List);
+			}
+		}
+	}
+
+	// position cursors at last record not newer than end of time window
+	TArray<int32, TInlineAllocator<EMessageSeverity::Info + 1>> Cursors;
+	for (FSequenceList* List : Lists)
+	{
+		int32 Low = List->Head, High = List->Sequences.Num();
+		while (Low < High)
+		{
+			const int32 Mid = Low + (High - Low) / 2;
+			if (GetRecord(List->Sequences[Mid]).Cycles <= EndCycles)
+			{
+				Low = Mid + 1;
+			}
+			else
+			{
+				High = Mid;
+			}
+		}
+		Cursors.Add(Low - 1);
+	}
+
+	// merge lists walking back from newest, so result limit keeps most recent matches
+	TArray<uint64, TInlineAllocator<64>> Matches;
+	while (Matches.Num() < InQuery.MaxResults)
+	{
+		int32 Best = INDEX_NONE;
+		for (int32 Index = 0; Index < Lists.Num(); ++Index)
+		{
+			if (Cursors[Index] >= Lists[Index]->Head
+				&& (Best == INDEX_NONE || Lists[Index]->Sequences[Cursors[Index]] > Lists[Best]->Sequences[Cursors[Best]]))
+			{
+				Best = Index;
+			}
+		}
+		if (Best == INDEX_NONE)
+		{
+			break;
+		}
+
+		const uint64 Sequence = Lists[Best]->Sequences[Cursors[Best]--];
+		if (GetRecord(Sequence).Cycles < StartCycles)
+		{
+			// remaining records of this list are older than time window
+			Cursors[Best] = Lists[Best]->Head - 1;
+			continue;
+		}
+		Matches.Add(Sequence);
+	}
+
+	for (int32 Index = Matches.Num() - 1; Index >= 0; --Index)
+	{
+		InVisitor(GetRecord(Matches[Index]));
+	}
+}
+
+void FBlueprintMessageHistory::Reset()
+{
+	for (FRecord& Record : Records)
+	{
+		Record = FRecord();
+	}
+	// sequence keeps growing so that stale references never resolve to new records
+	FirstSequence = NextSequence;
+	ByCategory.Reset();
+	for (FSequenceList& List : BySeverity)
+	{
+		List = FSequenceList();
+	}
+	if (Index.IsValid())
+	{
+		Index->Reset();
+	}
+}
+
+FBlueprintMessageHistoryEntry FBlueprintMessageHistory::MakeEntry(const FRecord& InRecord)
+{
+	FBlueprintMessageHistoryEntry Entry;
+	Entry.Category = InRecord.Category;
+	Entry.Severity = static_cast<EBlueprintMessageSeverity>(InRecord.Severity);
+	Entry.Time = FDateTime(InRecord.Ticks);
+	Entry.Text = InRecord.Message.IsValid() ? InRecord.Message->ToText() : FText::GetEmpty();
+	return Entry;
+}
@@ -0,0 +1,157 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlueprintMessageSink.h"
+#include "BlueprintMessageToken.h"
+#include "BlueprintMessageHistory.generated.h"
+
+class FBlueprintMessageHistoryIndex;
+
+/**
+ * Recently shown message as exposed to blueprints
+ */
+USTRUCT(BlueprintType, Category="Utilities|MessageLog")
+struct BLUEPRINTMESSAGE_API FBlueprintMessageHistoryEntry
+{
+	GENERATED_BODY()
+
+	/** Message log category of the message */
+	UPROPERTY(BlueprintReadOnly, Category="Utilities|MessageLog")
+	FName Category;
+
+	/** Severity of the message */
+	UPROPERTY(BlueprintReadOnly, Category="Utilities|MessageLog")
+	EBlueprintMessageSeverity Severity = EBlueprintMessageSeverity::Info;
+
+	/** UTC time message was shown */
+	UPROPERTY(BlueprintReadOnly, Category="Utilities|MessageLog")
+	FDateTime Time;
+
+	/** Full message text */
+	UPROPERTY(BlueprintReadOnly, Category="Utilities|MessageLog")
+	FText Text;
+};
+
+/**
+ * Fixed capacity history of last shown messages.
+ *
+ * Records are kept in ring buffer in order they were shown, with per category and per severity
+ * indices so that queries visit only matching records.
+ *
+ * Records are ordered by monotonic cycle counter, UTC time is kept for display only since wall clock can step back.
+ * Query time window is given in UTC and converted to cycles relative to the time history was created.
+ *
+ * Instance is owned by the module and receives messages as sink, all access is expected to happen on game thread.
+ */
+class BLUEPRINTMESSAGE_API FBlueprintMessageHistory : public IBlueprintMessageSink
+{
+public:
+	struct FRecord
+	{
+		/* Position of message in shown order */
+		uint64 Sequence = 0;
+		/* UTC time in ticks, for display */
+		int64 Ticks = 0;
+		/* Monotonic time in platform cycles, for ordering */
+		uint64 Cycles = 0;
+		FName Category;
+		EMessageSeverity::Type Severity = EMessageSeverity::Info;
+		/* Shown message, tokens are shared with message log */
+		TSharedPtr<FTokenizedMessage> Message;
+	};
+
+	struct FQuery
+	{
+		/* Category to match, None to match any */
+		FName Category;
+		/* Only messages of this or higher severity match */
+		EMessageSeverity::Type Severity = EMessageSeverity::Info;
+		/* Inclusive UTC time window in ticks */
+		int64 StartTicks = MIN_int64;
+		int64 EndTicks = MAX_int64;
+		/* Maximum number of most recent matches to visit */
+		int32 MaxResults = MAX_int32;
+	};
+
+	/* Ascending sequence numbers of records sharing a key, entries before Head are evicted */
+	struct FSequenceList
+	{
+		TArray<uint64> Sequences;
+		int32 Head = 0;
+
+		void Add(uint64 InSequence) { Sequences.Add(InSequence); }
+		void Trim(uint64 InOldest);
+		bool IsEmpty() const { return Head >= Sequences.Num(); }
+	};
+
+	/**
+	 * @param InCapacity number of records to keep
+	 * @param bInWithIndex maintain search index over record tokens
+	 */
+	explicit FBlueprintMessageHistory(int32 InCapacity, bool bInWithIndex = false);
+	virtual ~FBlueprintMessageHistory() override;
+
+	/** Get history instance, null if history is disabled */
+	static FBlueprintMessageHistory* Get() { return Instance; }
+
+	//~ Begin IBlueprintMessageSink Interface
+	virtual void ReceiveMessage(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage) override;
+	//~ End IBlueprintMessageSink Interface
+
+	/**
+	 * Visit records matching query in order they were shown.
+	 * Cost is proportional to number of matches.
+	 */
+	void Query(const FQuery& InQuery, TFunctionRef<void(const FRecord&)> InVisitor) const;
+
+	/** Get record by sequence number, null if it was evicted or not yet shown */
+	const FRecord* FindRecord(uint64 InSequence) const;
+
+	/** Number of records currently held */
+	int32 Num() const { return static_cast<int32>(NextSequence - GetOldestSequence()); }
+
+	/** Maximum number of records held */
+	int32 GetCapacity() const { return Records.Num(); }
+
+	/** Sequence number of oldest held record */
+	uint64 GetOldestSequence() const { return FMath::Max(FirstSequence, NextSequence > static_cast<uint64>(Records.Num()) ? NextSequence - Records.Num() : 0); }
+
+	/** Sequence number next shown message will receive */
+	uint64 GetNextSequence() const { return NextSequence; }
+
+	/** Drop all records */
+	void Reset();
+
+	/** Get search index over held records, null if disabled */
+	FBlueprintMessageHistoryIndex* GetIndex() const { return Index.Get(); }
+
+	/** Convert record to blueprint representation */
+	static FBlueprintMessageHistoryEntry MakeEntry(const FRecord& InRecord);
+
+private:
+	static FBlueprintMessageHistory* Instance;
+
+	const FRecord& GetRecord(uint64 InSequence) const { return Records[InSequence % Records.Num()]; }
+
+	/* Convert UTC time to monotonic cycles using clock pair captured at creation */
+	uint64 TicksToCycles(int64 InTicks) const;
+
+	/* Ring storage, record for sequence S lives at S % Capacity */
+	TArray<FRecord> Records;
+	uint64 NextSequence = 0;
+	/* Sequence of first record after last reset */
+	uint64 FirstSequence = 0;
+
+	/* UTC time and cycle counter captured together at creation */
+	int64 AnchorTicks = 0;
+	uint64 AnchorCycles = 0;
+
+	/* Records by category and severity */
+	mutable TMap<TPair<FName, uint8>, FSequenceList> ByCategory;
+	/* Records by severity */
+	mutable FSequenceList BySeverity[EMessageSeverity::Info + 1];
+
+	TUniquePtr<FBlueprintMessageHistoryIndex> Index;
+};
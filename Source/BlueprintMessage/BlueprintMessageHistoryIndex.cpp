@@ -0,0 +1,218 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageHistoryIndex.h"
+#include "BlueprintMessage.h"
+#include "Misc/UObjectToken.h"
+
+namespace
+{
+	// Terms shorter than this are not indexed
+	constexpr int32 MinTermLength = 2;
+	// Longer terms are truncated
+	constexpr int32 MaxTermLength = 64;
+}
+
+FBlueprintMessageHistoryIndex::FBlueprintMessageHistoryIndex(const FBlueprintMessageHistory& InHistory)
+	: History(InHistory)
+{
+}
+
+void FBlueprintMessageHistoryIndex::Tokenize(const FString& InText, TArray<FString, TInlineAllocator<16>>& OutTerms)
+{
+	const TCHAR* Data = *InText;
+	const int32 Len = InText.Len();
+
+	int32 Start = INDEX_NONE;
+	for (int32 Index = 0; Index <= Len; ++Index)
+	{
+		const bool bWordChar = Index < Len && (FChar::IsAlnum(Data[Index]) || Data[Index] == TEXT('_'));
+		if (bWordChar && Start == INDEX_NONE)
+		{
+			Start = Index;
+		}
+		else if (!bWordChar && Start != INDEX_NONE)
+		{
+			const int32 TermLen = FMath::Min(Index - Start, MaxTermLength);
+			if (TermLen >= MinTermLength)
+			{
+				FString Term(TermLen, Data + Start);
+				Term.ToLowerInline();
+				OutTerms.AddUnique(MoveTemp(Term));
+			}
+			Start = INDEX_NONE;
+		}
+	}
+}
+
+template<typename KeyType>
+void FBlueprintMessageHistoryIndex::AddPosting(TMap<KeyType, FSequenceList>& InMap, const KeyType& InKey, uint64 InSequence)
+{
+	FSequenceList& List = InMap.FindOrAdd(InKey);
+	// same key may occur in several tokens of one record
+	if (List.Sequences.Num() == 0 || List.Sequences.Last() != InSequence)
+	{
+		List.Add(InSequence);
+	}
+}
+
+template<typename KeyType>
+void FBlueprintMessageHistoryIndex::FindPostings(TMap<KeyType, FSequenceList>& InMap, const KeyType& InKey, TArray<uint64>& OutSequences) const
+{
+	OutSequences.Reset();
+	if (FSequenceList* List = InMap.Find(InKey))
+	{
+		List->Trim(History.GetOldestSequence());
+		OutSequences.Append(List->Sequences.GetData() + List->Head, List->Sequences.Num() - List->Head);
+	}
+}
+
+template<typename KeyType>
+void FBlueprintMessageHistoryIndex::Sweep(TMap<KeyType, FSequenceList>& InMap, uint64 InOldest)
+{
+	for (auto It = InMap.CreateIterator(); It; ++It)
+	{
+		It->Value.Trim(InOldest);
+		if (It->Value.IsEmpty())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FBlueprintMessageHistoryIndex::AddRecord(const FBlueprintMessageHistory::FRecord& InRecord)
+{
+	if (!InRecord.Message.IsValid())
+	{
+		return;
+	}
+
+	const uint64 Sequence = InRecord.Sequence;
+
+	TArray<FString, TInlineAllocator<16>> RecordTerms;
+	for (const TSharedRef<IMessageToken>& Token : InRecord.Message->GetMessageTokens())
+	{
+		switch (Token->GetType())
+		{
+		case EMessageToken::Object:
+			AddPosting(ObjectPaths, StaticCastSharedRef<FUObjectToken>(Token)->GetOriginalObjectPathName(), Sequence);
+			break;
+		case EMessageToken::Actor:
+		{
+			const TSharedRef<FActorToken> ActorToken = StaticCastSharedRef<FActorToken>(Token);
+			AddPosting(ObjectPaths, ActorToken->GetActorPath(), Sequence);
+			if (ActorToken->GetActorGuid().IsValid())
+			{
+				AddPosting(ActorGuids, ActorToken->GetActorGuid(), Sequence);
+			}
+			break;
+		}
+		case EMessageToken::AssetName:
+			AddPosting(ObjectPaths, StaticCastSharedRef<FAssetNameToken>(Token)->GetAssetName(), Sequence);
+			break;
+		default:
+		{
+			const FName Slot = UBlueprintMessage::FindSlotOfPlaceholder(Token.Get());
+			if (!Slot.IsNone())
+			{
+				AddPosting(Slots, Slot, Sequence);
+			}
+			break;
+		}
+		}
+
+		Tokenize(Token->ToText().ToString(), RecordTerms);
+	}
+
+	for (const FString& Term : RecordTerms)
+	{
+		AddPosting(Terms, Term, Sequence);
+	}
+
+	// drop keys of evicted records once per history capacity to keep memory bounded
+	if (++NumSinceSweep >= History.GetCapacity())
+	{
+		NumSinceSweep = 0;
+
+		const uint64 Oldest = History.GetOldestSequence();
+		Sweep(Terms, Oldest);
+		Sweep(ObjectPaths, Oldest);
+		Sweep(ActorGuids, Oldest);
+		Sweep(Slots, Oldest);
+	}
+}
+
+void FBlueprintMessageHistoryIndex::FindByText(const FString& InText, TArray<uint64>& OutSequences) const
+{
+	OutSequences.Reset();
+
+	TArray<FString, TInlineAllocator<16>> QueryTerms;
+	Tokenize(InText, QueryTerms);
+	if (QueryTerms.IsEmpty())
+	{
+		return;
+	}
+
+	const uint64 Oldest = History.GetOldestSequence();
+
+	// intersect starting from the shortest posting list
+	TArray<FSequenceList*, TInlineAllocator<16>> Lists;
+	for (const FString& Term : QueryTerms)
+	{
+		FSequenceList* List = Terms.Find(Term);
+		if (!List)
+		{
+			return;
+		}
+		List->Trim(Oldest);
+		Lists.Add(List);
+	}
+	Lists.Sort([](const FSequenceList& A, const FSequenceList& B)
+	{
+		return A.Sequences.Num() - A.Head < B.Sequences.Num() - B.Head;
+	});
+
+	OutSequences.Append(Lists[0]->Sequences.GetData() + Lists[0]->Head, Lists[0]->Sequences.Num() - Lists[0]->Head);
+	for (int32 ListIndex = 1; ListIndex < Lists.Num() && OutSequences.Num(); ++ListIndex)
+	{
+		const FSequenceList& List = *Lists[ListIndex];
+
+		int32 Write = 0;
+		int32 Cursor = List.Head;
+		for (const uint64 Sequence : OutSequences)
+		{
+			while (Cursor < List.Sequences.Num() && List.Sequences[Cursor] < Sequence)
+			{
+				++Cursor;
+			}
+			if (Cursor < List.Sequences.Num() && List.Sequences[Cursor] == Sequence)
+			{
+				OutSequences[Write++] = Sequence;
+			}
+		}
+		OutSequences.SetNum(Write);
+	}
+}
+
+void FBlueprintMessageHistoryIndex::FindByObjectPath(const FString& InPath, TArray<uint64>& OutSequences) const
+{
+	FindPostings(ObjectPaths, InPath, OutSequences);
+}
+
+void FBlueprintMessageHistoryIndex::FindByActorGuid(const FGuid& InGuid, TArray<uint64>& OutSequences) const
+{
+	FindPostings(ActorGuids, InGuid, OutSequences);
+}
+
+void FBlueprintMessageHistoryIndex::FindBySlot(const FName& InSlot, TArray<uint64>& OutSequences) const
+{
+	FindPostings(Slots, InSlot, OutSequences);
+}
+
+void FBlueprintMessageHistoryIndex::Reset()
+{
+	Terms.Reset();
+	ObjectPaths.Reset();
+	ActorGuids.Reset();
+	Slots.Reset();
+	NumSinceSweep = 0;
+}
@@ -0,0 +1,64 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlueprintMessageHistory.h"
+
+/**
+ * Inverted index over message history records.
+ *
+ * Maps text terms, referenced object paths, actor guids and unfilled slot names to sequence numbers
+ * of records containing them. Updated incrementally as messages are received by history, evicted
+ * records are dropped lazily.
+ *
+ * All results are ascending sequence numbers of records still held by history.
+ */
+class BLUEPRINTMESSAGE_API FBlueprintMessageHistoryIndex
+{
+public:
+	explicit FBlueprintMessageHistoryIndex(const FBlueprintMessageHistory& InHistory);
+
+	/** Index newly added history record */
+	void AddRecord(const FBlueprintMessageHistory::FRecord& InRecord);
+
+	/** Find records containing all words of text, case insensitive */
+	void FindByText(const FString& InText, TArray<uint64>& OutSequences) const;
+
+	/** Find records referencing object, actor or asset by path */
+	void FindByObjectPath(const FString& InPath, TArray<uint64>& OutSequences) const;
+
+	/** Find records referencing actor by guid */
+	void FindByActorGuid(const FGuid& InGuid, TArray<uint64>& OutSequences) const;
+
+	/** Find records shown with slot left unfilled */
+	void FindBySlot(const FName& InSlot, TArray<uint64>& OutSequences) const;
+
+	/** Drop all entries */
+	void Reset();
+
+	/** Split text into lowercase index terms */
+	static void Tokenize(const FString& InText, TArray<FString, TInlineAllocator<16>>& OutTerms);
+
+private:
+	using FSequenceList = FBlueprintMessageHistory::FSequenceList;
+
+	template<typename KeyType>
+	static void AddPosting(TMap<KeyType, FSequenceList>& InMap, const KeyType& InKey, uint64 InSequence);
+
+	template<typename KeyType>
+	void FindPostings(TMap<KeyType, FSequenceList>& InMap, const KeyType& InKey, TArray<uint64>& OutSequences) const;
+
+	template<typename KeyType>
+	static void Sweep(TMap<KeyType, FSequenceList>& InMap, uint64 InOldest);
+
+	const FBlueprintMessageHistory& History;
+
+	mutable TMap<FString, FSequenceList> Terms;
+	mutable TMap<FString, FSequenceList> ObjectPaths;
+	mutable TMap<FGuid, FSequenceList> ActorGuids;
+	mutable TMap<FName, FSequenceList> Slots;
+
+	/* Number of records added since last sweep of evicted keys */
+	int32 NumSinceSweep = 0;
+};
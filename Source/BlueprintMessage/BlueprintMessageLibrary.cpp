@@ -2,13 +2,37 @@
 
 
 #include "BlueprintMessageLibrary.h"
+#include "BlueprintMessage.h"
 #include "BlueprintMessageSettings.h"
+#include "BlueprintMessageQueue.h"
+#include "BlueprintMessageCategoryGate.h"
+#include "BlueprintMessageHistoryIndex.h"
 #include "Logging/MessageLog.h"
+#include "HAL/FileManager.h"
 
 #if WITH_EDITOR
 #include "Modules/ModuleManager.h"
 #include "MessageLogModule.h"
 #include "IMessageLogListing.h"
+
+namespace BlueprintMessageLibrary
+{
+	// Size of text accumulated before it is written out on export
+	constexpr int32 ExportChunkSize = 64 * 1024;
+	// Upper bound of messages returned in single page
+	constexpr int32 MaxPageSize = 10000;
+
+	TSharedPtr<IMessageLogListing> FindLogListing(const FName& Category)
+	{
+		FMessageLogModule& MessageLogModule = FModuleManager::LoadModuleChecked<FMessageLogModule>("MessageLog");
+		return MessageLogModule.IsRegisteredLogListing(Category) ? MessageLogModule.GetLogListing(Category) : TSharedPtr<IMessageLogListing>();
+	}
+
+	bool PassesSeverity(const TSharedRef<FTokenizedMessage>& Message, EBlueprintMessageSeverity Severity)
+	{
+		return Message->GetSeverity() <= static_cast<EMessageSeverity::Type>(Severity);
+	}
+}
 #endif
 
 TArray<FName> UBlueprintMessageLibrary::GetAvailableCategories()
@@ -53,11 +77,207 @@ void UBlueprintMessageLibrary::MessageLogClear(FName Category)
 FString UBlueprintMessageLibrary::MessageLogCopyAllMessages(FName Category)
 {
 #if WITH_EDITOR
-	FMessageLogModule& MessageLogModule = FModuleManager::LoadModuleChecked<FMessageLogModule>("MessageLog");
-	if (MessageLogModule.IsRegisteredLogListing(Category))
+	if (TSharedPtr<IMessageLogListing> Listing = BlueprintMessageLibrary::FindLogListing(Category))
 	{
-		MessageLogModule.GetLogListing(Category)->GetAllMessagesAsString();
+		return Listing->GetAllMessagesAsString();
 	}
 #endif
 	return FString();
 }
+
+int32 UBlueprintMessageLibrary::MessageLogExportToFile(FName LogCategory, const FString& FilePath, EBlueprintMessageSeverity Severity, bool bAppend)
+{
+	int32 Result = 0;
+#if WITH_EDITOR
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath, bAppend ? FILEWRITE_Append : FILEWRITE_None));
+	if (!Writer.IsValid())
+	{
+		UE_LOG(LogBlueprintMessage, Warning, TEXT("Failed to open %s for message log export"), *FilePath);
+		return 0;
+	}
+	Result = MessageLogExport(LogCategory, *Writer, Severity);
+	Writer->Close();
+#endif
+	return Result;
+}
+
+int32 UBlueprintMessageLibrary::MessageLogExport(FName LogCategory, FArchive& Ar, EBlueprintMessageSeverity Severity)
+{
+	int32 Result = 0;
+#if WITH_EDITOR
+	TSharedPtr<IMessageLogListing> Listing = BlueprintMessageLibrary::FindLogListing(LogCategory);
+	if (!Listing.IsValid())
+	{
+		return 0;
+	}
+
+	TArray<uint8> Chunk;
+	Chunk.Reserve(BlueprintMessageLibrary::ExportChunkSize);
+	for (const TSharedRef<FTokenizedMessage>& Message : Listing->GetFilteredMessages())
+	{
+		if (!BlueprintMessageLibrary::PassesSeverity(Message, Severity))
+		{
+			continue;
+		}
+
+		const FString Line = Message->ToText().ToString();
+		const FTCHARToUTF8 Converted(*Line, Line.Len());
+		if (Chunk.Num() + Converted.Length() + 1 > BlueprintMessageLibrary::ExportChunkSize)
+		{
+			Ar.Serialize(Chunk.GetData(), Chunk.Num());
+			Chunk.Reset();
+		}
+		Chunk.Append(reinterpret_cast<const uint8*>(Converted.Get()), Converted.Length());
+		Chunk.Add('\n');
+		++Result;
+	}
+	Ar.Serialize(Chunk.GetData(), Chunk.Num());
+#endif
+	return Result;
+}
+
+TArray<FString> UBlueprintMessageLibrary::MessageLogGetMessages(FName LogCategory, int32 Offset, int32& TotalCount, int32 Count, EBlueprintMessageSeverity Severity)
+{
+	TArray<FString> Result;
+	TotalCount = 0;
+#if WITH_EDITOR
+	TSharedPtr<IMessageLogListing> Listing = BlueprintMessageLibrary::FindLogListing(LogCategory);
+	if (!Listing.IsValid())
+	{
+		return Result;
+	}
+
+	Offset = FMath::Max(Offset, 0);
+	Count = FMath::Clamp(Count, 0, BlueprintMessageLibrary::MaxPageSize);
+	Result.Reserve(Count);
+
+	for (const TSharedRef<FTokenizedMessage>& Message : Listing->GetFilteredMessages())
+	{
+		if (!BlueprintMessageLibrary::PassesSeverity(Message, Severity))
+		{
+			continue;
+		}
+		if (TotalCount >= Offset && Result.Num() < Count)
+		{
+			Result.Add(Message->ToText().ToString());
+		}
+		++TotalCount;
+	}
+#endif
+	return Result;
+}
+
+bool UBlueprintMessageLibrary::IsCategoryEnabled(FName LogCategory, EBlueprintMessageSeverity Severity)
+{
+	return FBlueprintMessageCategoryGate::IsEnabled(LogCategory, Severity);
+}
+
+FBlueprintMessagePoolStats UBlueprintMessageLibrary::GetMessagePoolStats()
+{
+	const FBlueprintMessagePool* Pool = FBlueprintMessagePool::Get();
+	return Pool ? Pool->GetStats() : FBlueprintMessagePoolStats();
+}
+
+void UBlueprintMessageLibrary::TrimMessagePool(int32 MaxSize)
+{
+	if (FBlueprintMessagePool* Pool = FBlueprintMessagePool::Get())
+	{
+		Pool->Trim(MaxSize);
+	}
+}
+
+void UBlueprintMessageLibrary::FlushMessageQueue()
+{
+	if (FBlueprintMessageQueue* Queue = FBlueprintMessageQueue::Get())
+	{
+		Queue->Flush();
+	}
+}
+
+TArray<FBlueprintMessageHistoryEntry> UBlueprintMessageLibrary::QueryMessageHistory(FName LogCategory, EBlueprintMessageSeverity Severity, const FDateTime& StartTime, const FDateTime& EndTime, int32 MaxResults)
+{
+	TArray<FBlueprintMessageHistoryEntry> Result;
+
+	const FBlueprintMessageHistory* History = FBlueprintMessageHistory::Get();
+	if (!History || MaxResults <= 0)
+	{
+		return Result;
+	}
+
+	FBlueprintMessageHistory::FQuery Query;
+	Query.Category = LogCategory;
+	Query.Severity = static_cast<EMessageSeverity::Type>(Severity);
+	if (StartTime.GetTicks() != 0)
+	{
+		Query.StartTicks = StartTime.GetTicks();
+	}
+	if (EndTime.GetTicks() != 0)
+	{
+		Query.EndTicks = EndTime.GetTicks();
+	}
+	Query.MaxResults = MaxResults;
+
+	History->Query(Query, [&Result](const FBlueprintMessageHistory::FRecord& Record)
+	{
+		Result.Add(FBlueprintMessageHistory::MakeEntry(Record));
+	});
+	return Result;
+}
+
+namespace BlueprintMessageLibrary
+{
+	TArray<FBlueprintMessageHistoryEntry> ResolveHistoryEntries(const FBlueprintMessageHistory& History, const TArray<uint64>& Sequences, int32 MaxResults)
+	{
+		TArray<FBlueprintMessageHistoryEntry> Result;
+		const int32 First = FMath::Max(Sequences.Num() - FMath::Max(MaxResults, 0), 0);
+		Result.Reserve(Sequences.Num() - First);
+		for (int32 Index = First; Index < Sequences.Num(); ++Index)
+		{
+			if (const FBlueprintMessageHistory::FRecord* Record = History.FindRecord(Sequences[Index]))
+			{
+				Result.Add(FBlueprintMessageHistory::MakeEntry(*Record));
+			}
+		}
+		return Result;
+	}
+}
+
+TArray<FBlueprintMessageHistoryEntry> UBlueprintMessageLibrary::SearchMessageHistory(const FString& Text, int32 MaxResults)
+{
+	const FBlueprintMessageHistory* History = FBlueprintMessageHistory::Get();
+	if (!History || !History->GetIndex())
+	{
+		return TArray<FBlueprintMessageHistoryEntry>();
+	}
+
+	TArray<uint64> Sequences;
+	History->GetIndex()->FindByText(Text, Sequences);
+	return BlueprintMessageLibrary::ResolveHistoryEntries(*History, Sequences, MaxResults);
+}
+
+TArray<FBlueprintMessageHistoryEntry> UBlueprintMessageLibrary::FindMessagesReferencingObject(const UObject* Object, int32 MaxResults)
+{
+	const FBlueprintMessageHistory* History = FBlueprintMessageHistory::Get();
+	if (!History || !History->GetIndex() || !Object)
+	{
+		return TArray<FBlueprintMessageHistoryEntry>();
+	}
+
+	TArray<uint64> Sequences;
+	History->GetIndex()->FindByObjectPath(Object->GetPathName(), Sequences);
+	return BlueprintMessageLibrary::ResolveHistoryEntries(*History, Sequences, MaxResults);
+}
+
+int32 UBlueprintMessageLibrary::GetMessageHistorySize()
+{
+	const FBlueprintMessageHistory* History = FBlueprintMessageHistory::Get();
+	return History ? History->Num() : 0;
+}
+
+void UBlueprintMessageLibrary::ClearMessageHistory()
+{
+	if (FBlueprintMessageHistory* History = FBlueprintMessageHistory::Get())
+	{
+		History->Reset();
+	}
+}
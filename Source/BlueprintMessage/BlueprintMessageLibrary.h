@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "BlueprintMessageToken.h"
+#include "BlueprintMessagePool.h"
+#include "BlueprintMessageHistory.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "BlueprintMessageLibrary.generated.h"
 
@@ -65,8 +67,140 @@ public:
 	 * @param LogCategory Log category name
 	 * @return Content of all messages in log category
 	 */
-	UFUNCTION(BlueprintCallable, DisplayName="Copy Message Log", Category="Utilities|MessageLog", meta=(DevelopmentOnly=true))
+	UFUNCTION(BlueprintCallable, DisplayName="Copy Message Log", Category="Utilities|MessageLog", meta=(DevelopmentOnly=true, DeprecatedFunction, DeprecationMessage="Builds single string of whole log, use Export Message Log or Get Message Log Page"))
 	static FString MessageLogCopyAllMessages(
 		UPARAM(DisplayName="Category", meta=(GetOptions="BlueprintMessage.BlueprintMessageLibrary.GetAvailableCategories")) FName LogCategory = TEXT("BlueprintLog"));
 
+	/**
+	 * Write text of messages from message log category to file, one message per line.
+	 *
+	 * @param LogCategory Log category name
+	 * @param FilePath File to write messages to
+	 * @param Severity Only messages of this or higher severity are written
+	 * @param bAppend Append to existing file instead of replacing it
+	 * @return Number of messages written
+	 */
+	UFUNCTION(BlueprintCallable, DisplayName="Export Message Log", Category="Utilities|MessageLog", meta=(DevelopmentOnly=true))
+	static int32 MessageLogExportToFile(
+		UPARAM(DisplayName="Category", meta=(GetOptions="BlueprintMessage.BlueprintMessageLibrary.GetAvailableCategories")) FName LogCategory,
+		const FString& FilePath,
+		EBlueprintMessageSeverity Severity = EBlueprintMessageSeverity::Info,
+		bool bAppend = false);
+
+	/**
+	 * Get text of a range of messages from message log category.
+	 *
+	 * @param LogCategory Log category name
+	 * @param Offset Index of first message to return, counted among messages passing severity filter
+	 * @param Count Maximum number of messages to return
+	 * @param Severity Only messages of this or higher severity are considered
+	 * @param TotalCount Number of messages passing severity filter
+	 * @return Text of requested messages
+	 */
+	UFUNCTION(BlueprintCallable, DisplayName="Get Message Log Page", Category="Utilities|MessageLog", meta=(DevelopmentOnly=true))
+	static TArray<FString> MessageLogGetMessages(
+		UPARAM(DisplayName="Category", meta=(GetOptions="BlueprintMessage.BlueprintMessageLibrary.GetAvailableCategories")) FName LogCategory,
+		int32 Offset,
+		int32& TotalCount,
+		int32 Count = 100,
+		EBlueprintMessageSeverity Severity = EBlueprintMessageSeverity::Info);
+
+	/**
+	 * Write text of messages from message log category to archive as UTF-8, one message per line.
+	 * Text is accumulated and written in chunks of limited size.
+	 *
+	 * @param LogCategory Log category name
+	 * @param Ar Archive to write to
+	 * @param Severity Only messages of this or higher severity are written
+	 * @return Number of messages written
+	 */
+	static int32 MessageLogExport(FName LogCategory, FArchive& Ar, EBlueprintMessageSeverity Severity = EBlueprintMessageSeverity::Info);
+
+	/**
+	 * Check whether messages of category and severity are enabled by console variables.
+	 * Create Message nodes branch on this before message is built.
+	 *
+	 * @param LogCategory Log category name
+	 * @param Severity Message severity
+	 * @return True if message would be shown
+	 */
+	UFUNCTION(BlueprintPure, DisplayName="Is Message Category Enabled", Category="Utilities|MessageLog")
+	static bool IsCategoryEnabled(
+		UPARAM(DisplayName="Category", meta=(GetOptions="BlueprintMessage.BlueprintMessageLibrary.GetAvailableCategories")) FName LogCategory,
+		EBlueprintMessageSeverity Severity);
+
+	/**
+	 * Get message object pool usage counters
+	 *
+	 * @return Current pool counters
+	 */
+	UFUNCTION(BlueprintPure, DisplayName="Get Message Pool Stats", Category="Utilities|MessageLog")
+	static FBlueprintMessagePoolStats GetMessagePoolStats();
+
+	/**
+	 * Release idle pooled message objects
+	 *
+	 * @param MaxSize Number of idle messages to keep
+	 */
+	UFUNCTION(BlueprintCallable, DisplayName="Trim Message Pool", Category="Utilities|MessageLog")
+	static void TrimMessagePool(int32 MaxSize = 0);
+
+	/**
+	 * Deliver all messages waiting in batched delivery queue to the Message Log
+	 */
+	UFUNCTION(BlueprintCallable, DisplayName="Flush Message Queue", Category="Utilities|MessageLog")
+	static void FlushMessageQueue();
+
+	/**
+	 * Get recently shown messages from message history
+	 *
+	 * @param LogCategory Category to match, None to match any category
+	 * @param Severity Only messages of this or higher severity are returned
+	 * @param StartTime Earliest UTC time of returned messages, ignored if not set
+	 * @param EndTime Latest UTC time of returned messages, ignored if not set
+	 * @param MaxResults Maximum number of most recent messages to return
+	 * @return Matching messages in order they were shown
+	 */
+	UFUNCTION(BlueprintCallable, DisplayName="Query Message History", Category="Utilities|MessageLog", meta=(AutoCreateRefTerm="StartTime,EndTime"))
+	static TArray<FBlueprintMessageHistoryEntry> QueryMessageHistory(
+		UPARAM(DisplayName="Category", meta=(GetOptions="BlueprintMessage.BlueprintMessageLibrary.GetAvailableCategories")) FName LogCategory,
+		EBlueprintMessageSeverity Severity,
+		const FDateTime& StartTime,
+		const FDateTime& EndTime,
+		int32 MaxResults = 100);
+
+	/**
+	 * Find messages in message history containing all words of text.
+	 * Requires message history index to be enabled.
+	 *
+	 * @param Text Words to look for, case insensitive
+	 * @param MaxResults Maximum number of most recent messages to return
+	 * @return Matching messages in order they were shown
+	 */
+	UFUNCTION(BlueprintCallable, DisplayName="Search Message History", Category="Utilities|MessageLog")
+	static TArray<FBlueprintMessageHistoryEntry> SearchMessageHistory(const FString& Text, int32 MaxResults = 100);
+
+	/**
+	 * Find messages in message history referencing object, actor or asset.
+	 * Requires message history index to be enabled.
+	 *
+	 * @param Object Referenced object
+	 * @param MaxResults Maximum number of most recent messages to return
+	 * @return Matching messages in order they were shown
+	 */
+	UFUNCTION(BlueprintCallable, DisplayName="Find Messages Referencing Object", Category="Utilities|MessageLog")
+	static TArray<FBlueprintMessageHistoryEntry> FindMessagesReferencingObject(const UObject* Object, int32 MaxResults = 100);
+
+	/**
+	 * Get number of messages currently kept in message history
+	 */
+	UFUNCTION(BlueprintPure, DisplayName="Get Message History Size", Category="Utilities|MessageLog")
+	static int32 GetMessageHistorySize();
+
+	/**
+	 * Drop all messages kept in message history
+	 */
+	UFUNCTION(BlueprintCallable, DisplayName="Clear Message History", Category="Utilities|MessageLog")
+	static void ClearMessageHistory();
+
 };
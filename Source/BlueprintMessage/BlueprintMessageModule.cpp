@@ -2,6 +2,16 @@
 
 #include "BlueprintMessageModule.h"
 #include "BlueprintMessage.h"
+#include "BlueprintMessagePool.h"
+#include "BlueprintMessageQueue.h"
+#include "BlueprintMessageSuppressor.h"
+#include "BlueprintMessageOutputSink.h"
+#include "BlueprintMessageBinarySink.h"
+#include "BlueprintMessageHistory.h"
+#include "BlueprintMessageTokenCache.h"
+#include "BlueprintMessageCategoryGate.h"
+#include "BlueprintMessageCallSite.h"
+#include "BlueprintMessageSettings.h"
 
 IMPLEMENT_MODULE(FBlueprintMessageModule, BlueprintMessage);
 
@@ -9,8 +19,57 @@ DEFINE_LOG_CATEGORY(LogBlueprintMessage);
 
 void FBlueprintMessageModule::StartupModule()
 {
+	MessagePool = MakeUnique<FBlueprintMessagePool>();
+	MessageQueue = MakeUnique<FBlueprintMessageQueue>();
+	MessageSuppressor = MakeUnique<FBlueprintMessageSuppressor>();
+	CategoryGate = MakeUnique<FBlueprintMessageCategoryGate>();
+	CallSiteRegistry = MakeUnique<FBlueprintMessageCallSiteRegistry>();
+
+	const UBlueprintMessageSettings* Settings = UBlueprintMessageSettings::Get();
+	if (Settings->bInternTokens)
+	{
+		TokenCache = MakeUnique<FBlueprintMessageTokenCache>(Settings->TokenCacheSize);
+	}
+	if (Settings->bEnableRuntimeSink && (!WITH_EDITOR || Settings->bRuntimeSinkInEditor) && (!UE_BUILD_SHIPPING || Settings->bRuntimeSinkInShipping))
+	{
+		RuntimeSink = MakeShared<FBlueprintMessageOutputSink>(Settings->bRuntimeSinkWriteToLog, Settings->RuntimeSinkFilePath);
+		FBlueprintMessageSinks::Register(RuntimeSink.ToSharedRef());
+	}
+	if (Settings->bEnableBinarySink && !Settings->BinarySinkFilePath.IsEmpty())
+	{
+		BinarySink = MakeShared<FBlueprintMessageBinarySink>(Settings->BinarySinkFilePath, Settings->BinarySinkBufferSize);
+		FBlueprintMessageSinks::Register(BinarySink.ToSharedRef());
+	}
+	if (Settings->bEnableMessageHistory && (!UE_BUILD_SHIPPING || Settings->bMessageHistoryInShipping))
+	{
+		MessageHistory = MakeShared<FBlueprintMessageHistory>(Settings->MessageHistoryCapacity, Settings->bEnableMessageHistoryIndex);
+		FBlueprintMessageSinks::Register(MessageHistory.ToSharedRef());
+	}
 }
 
 void FBlueprintMessageModule::ShutdownModule()
 {
+	// suppressor emits pending counters to queue, queue delivers remaining messages on destruction
+	MessageSuppressor.Reset();
+	MessageQueue.Reset();
+
+	if (RuntimeSink.IsValid())
+	{
+		FBlueprintMessageSinks::Unregister(RuntimeSink.ToSharedRef());
+		RuntimeSink.Reset();
+	}
+	if (BinarySink.IsValid())
+	{
+		FBlueprintMessageSinks::Unregister(BinarySink.ToSharedRef());
+		BinarySink.Reset();
+	}
+	if (MessageHistory.IsValid())
+	{
+		FBlueprintMessageSinks::Unregister(MessageHistory.ToSharedRef());
+		MessageHistory.Reset();
+	}
+	CallSiteRegistry.Reset();
+	CategoryGate.Reset();
+	MessagePool.Reset();
+	TokenCache.Reset();
 }
@@ -3,9 +3,29 @@
 #include "Modules/ModuleInterface.h"
 #include "Modules/ModuleManager.h"
 
+class FBlueprintMessagePool;
+class FBlueprintMessageQueue;
+class FBlueprintMessageSuppressor;
+class IBlueprintMessageSink;
+class FBlueprintMessageHistory;
+class FBlueprintMessageTokenCache;
+class FBlueprintMessageCategoryGate;
+class FBlueprintMessageCallSiteRegistry;
+
 class FBlueprintMessageModule : public IModuleInterface
 {
 public:
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+	TUniquePtr<FBlueprintMessagePool> MessagePool;
+	TUniquePtr<FBlueprintMessageQueue> MessageQueue;
+	TUniquePtr<FBlueprintMessageSuppressor> MessageSuppressor;
+	TUniquePtr<FBlueprintMessageTokenCache> TokenCache;
+	TUniquePtr<FBlueprintMessageCategoryGate> CategoryGate;
+	TUniquePtr<FBlueprintMessageCallSiteRegistry> CallSiteRegistry;
+	TSharedPtr<IBlueprintMessageSink> RuntimeSink;
+	TSharedPtr<IBlueprintMessageSink> BinarySink;
+	TSharedPtr<FBlueprintMessageHistory> MessageHistory;
 };
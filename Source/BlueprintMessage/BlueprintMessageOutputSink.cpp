@@ -0,0 +1,96 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageOutputSink.h"
+#include "BlueprintMessage.h"
+#include "BlueprintMessageTextRenderer.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+FBlueprintMessageOutputSink::FBlueprintMessageOutputSink(bool bInWriteToLog, const FString& InFilePath)
+	: bWriteToLog(bInWriteToLog)
+{
+	if (!InFilePath.IsEmpty())
+	{
+		const FString FullPath = FPaths::IsRelative(InFilePath) ? FPaths::Combine(FPaths::ProjectLogDir(), InFilePath) : InFilePath;
+		FileWriter.Reset(IFileManager::Get().CreateFileWriter(*FullPath, FILEWRITE_Append | FILEWRITE_AllowRead));
+		if (!FileWriter.IsValid())
+		{
+			UE_LOG(LogBlueprintMessage, Warning, TEXT("Failed to open message sink file %s"), *FullPath);
+		}
+	}
+
+	FileBuffer.Reserve(1024);
+}
+
+FBlueprintMessageOutputSink::~FBlueprintMessageOutputSink()
+{
+	Flush();
+
+	UE_LOG(LogBlueprintMessage, Verbose, TEXT("Output sink delivered %llu messages, average cost %.2f us"), NumMessages, GetAverageCostMicroseconds());
+}
+
+const TCHAR* FBlueprintMessageOutputSink::SeverityToString(EMessageSeverity::Type InSeverity)
+{
+	switch (InSeverity)
+	{
+	case EMessageSeverity::CriticalError: return TEXT("CriticalError");
+	case EMessageSeverity::Error: return TEXT("Error");
+	case EMessageSeverity::PerformanceWarning: return TEXT("PerformanceWarning");
+	case EMessageSeverity::Warning: return TEXT("Warning");
+	default: return TEXT("Info");
+	}
+}
+
+void FBlueprintMessageOutputSink::ReceiveMessage(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage)
+{
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	Line.Reset();
+	Line << TEXT('[') << InCategory << TEXT("] ") << SeverityToString(InMessage->GetSeverity()) << TEXT(": ");
+	FBlueprintMessageTextRenderer::RenderTokens(*InMessage, Line);
+
+	if (bWriteToLog)
+	{
+		switch (InMessage->GetSeverity())
+		{
+		case EMessageSeverity::CriticalError:
+		case EMessageSeverity::Error:
+			UE_LOG(LogBlueprintMessage, Error, TEXT("%s"), Line.ToString());
+			break;
+		case EMessageSeverity::PerformanceWarning:
+		case EMessageSeverity::Warning:
+			UE_LOG(LogBlueprintMessage, Warning, TEXT("%s"), Line.ToString());
+			break;
+		default:
+			UE_LOG(LogBlueprintMessage, Log, TEXT("%s"), Line.ToString());
+			break;
+		}
+	}
+
+	if (FileWriter.IsValid())
+	{
+		Line << LINE_TERMINATOR;
+
+		const int32 Length = FPlatformString::ConvertedLength<UTF8CHAR>(Line.GetData(), Line.Len());
+		FileBuffer.Reset();
+		FileBuffer.AddUninitialized(Length);
+		FPlatformString::Convert(FileBuffer.GetData(), Length, Line.GetData(), Line.Len());
+		FileWriter->Serialize(FileBuffer.GetData(), Length);
+	}
+
+	++NumMessages;
+	TotalCycles += FPlatformTime::Cycles64() - StartCycles;
+}
+
+void FBlueprintMessageOutputSink::Flush()
+{
+	if (FileWriter.IsValid())
+	{
+		FileWriter->Flush();
+	}
+}
+
+double FBlueprintMessageOutputSink::GetAverageCostMicroseconds() const
+{
+	return NumMessages ? FPlatformTime::ToSeconds64(TotalCycles) * 1000000.0 / NumMessages : 0.0;
+}
@@ -0,0 +1,50 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlueprintMessageSink.h"
+
+class FArchive;
+
+/**
+ * Default runtime sink writing messages as text lines to output log and/or a file.
+ *
+ * Tokens are rendered into a reused line buffer, so steady state delivery does not allocate
+ * except for what token implementations do in ToText().
+ *
+ * Average cost per message is tracked and reported in log when sink is destroyed,
+ * use `log LogBlueprintMessage Verbose` to see it.
+ */
+class BLUEPRINTMESSAGE_API FBlueprintMessageOutputSink : public IBlueprintMessageSink
+{
+public:
+	/**
+	 * @param bInWriteToLog write messages to LogBlueprintMessage
+	 * @param InFilePath path to append messages to, no file is written if empty
+	 */
+	FBlueprintMessageOutputSink(bool bInWriteToLog, const FString& InFilePath);
+	virtual ~FBlueprintMessageOutputSink() override;
+
+	//~ Begin IBlueprintMessageSink Interface
+	virtual void ReceiveMessage(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage) override;
+	virtual void Flush() override;
+	//~ End IBlueprintMessageSink Interface
+
+	/** Average time spent per message in microseconds */
+	double GetAverageCostMicroseconds() const;
+
+private:
+	static const TCHAR* SeverityToString(EMessageSeverity::Type InSeverity);
+
+	/* Reused rendering buffer */
+	TStringBuilder<1024> Line;
+	/* Reused UTF-8 conversion buffer */
+	TArray<UTF8CHAR> FileBuffer;
+
+	bool bWriteToLog = true;
+	TUniquePtr<FArchive> FileWriter;
+
+	uint64 NumMessages = 0;
+	uint64 TotalCycles = 0;
+};
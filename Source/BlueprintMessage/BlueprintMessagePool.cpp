@@ -0,0 +1,106 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessagePool.h"
+#include "BlueprintMessage.h"
+#include "BlueprintMessageSettings.h"
+#include "UObject/Package.h"
+#include "Misc/EngineVersionComparison.h"
+
+namespace
+{
+	UBlueprintMessage* PopNoShrink(TArray<TObjectPtr<UBlueprintMessage>>& Array)
+	{
+#if UE_VERSION_OLDER_THAN(5, 4, 0)
+		return Array.Pop(false);
+#else
+		return Array.Pop(EAllowShrinking::No);
+#endif
+	}
+}
+
+FBlueprintMessagePool* FBlueprintMessagePool::Instance = nullptr;
+
+FBlueprintMessagePool::FBlueprintMessagePool()
+{
+	check(Instance == nullptr);
+	Instance = this;
+}
+
+FBlueprintMessagePool::~FBlueprintMessagePool()
+{
+	check(Instance == this);
+	Instance = nullptr;
+}
+
+UBlueprintMessage* FBlueprintMessagePool::Acquire()
+{
+	check(IsInGameThread());
+
+	if (FreeList.IsEmpty())
+	{
+		++Stats.Misses;
+		return nullptr;
+	}
+
+	UBlueprintMessage* Object = PopNoShrink(FreeList);
+	Object->bInPool = false;
+	++Stats.Hits;
+	return Object;
+}
+
+bool FBlueprintMessagePool::Release(UBlueprintMessage* Message)
+{
+	check(IsInGameThread());
+
+	if (!::IsValid(Message) || Message->HasAnyFlags(RF_ClassDefaultObject) || Message->GetOuter() != GetTransientPackage())
+	{
+		return false;
+	}
+
+	if (Message->bInPool)
+	{
+		// already recycled, treat repeated destroy as handled
+		return true;
+	}
+
+	if (FreeList.Num() >= UBlueprintMessageSettings::Get()->MessagePoolSize)
+	{
+		++Stats.Discarded;
+		return false;
+	}
+
+	Message->ResetMessage();
+	Message->bInPool = true;
+	FreeList.Add(Message);
+	++Stats.Recycled;
+	return true;
+}
+
+void FBlueprintMessagePool::Trim(int32 MaxSize)
+{
+	check(IsInGameThread());
+
+	while (FreeList.Num() > FMath::Max(MaxSize, 0))
+	{
+		UBlueprintMessage* Object = PopNoShrink(FreeList);
+		Object->bInPool = false;
+		Object->MarkAsGarbage();
+	}
+}
+
+FBlueprintMessagePoolStats FBlueprintMessagePool::GetStats() const
+{
+	FBlueprintMessagePoolStats Result = Stats;
+	Result.FreeCount = FreeList.Num();
+	return Result;
+}
+
+void FBlueprintMessagePool::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObjects(FreeList);
+}
+
+FString FBlueprintMessagePool::GetReferencerName() const
+{
+	return TEXT("FBlueprintMessagePool");
+}
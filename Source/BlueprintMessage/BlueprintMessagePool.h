@@ -0,0 +1,85 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+#include "BlueprintMessagePool.generated.h"
+
+class UBlueprintMessage;
+
+/**
+ * Message pool usage counters
+ */
+USTRUCT(BlueprintType, Category="Utilities|MessageLog")
+struct BLUEPRINTMESSAGE_API FBlueprintMessagePoolStats
+{
+	GENERATED_BODY()
+
+	/** Number of message requests served from the pool */
+	UPROPERTY(BlueprintReadOnly, Category="Utilities|MessageLog")
+	int64 Hits = 0;
+
+	/** Number of message requests that had to construct a new object */
+	UPROPERTY(BlueprintReadOnly, Category="Utilities|MessageLog")
+	int64 Misses = 0;
+
+	/** Number of messages returned to the pool */
+	UPROPERTY(BlueprintReadOnly, Category="Utilities|MessageLog")
+	int64 Recycled = 0;
+
+	/** Number of messages left to garbage collector because pool was full */
+	UPROPERTY(BlueprintReadOnly, Category="Utilities|MessageLog")
+	int64 Discarded = 0;
+
+	/** Number of idle messages currently held by the pool */
+	UPROPERTY(BlueprintReadOnly, Category="Utilities|MessageLog")
+	int32 FreeCount = 0;
+};
+
+/**
+ * Bounded free list of message objects.
+ *
+ * Instance is owned by the module, all access is expected to happen on game thread.
+ */
+class BLUEPRINTMESSAGE_API FBlueprintMessagePool : public FGCObject
+{
+public:
+	FBlueprintMessagePool();
+	virtual ~FBlueprintMessagePool();
+
+	/** Get pool instance, null if module is not loaded */
+	static FBlueprintMessagePool* Get() { return Instance; }
+
+	/**
+	 * Take an idle message from the pool.
+	 * @return message instance or null if pool is empty
+	 */
+	UBlueprintMessage* Acquire();
+
+	/**
+	 * Reset message and put it to the pool.
+	 * @param Message message to recycle
+	 * @return true if message was taken by the pool
+	 */
+	bool Release(UBlueprintMessage* Message);
+
+	/** Drop idle messages exceeding specified count */
+	void Trim(int32 MaxSize);
+
+	/** Get current pool counters */
+	FBlueprintMessagePoolStats GetStats() const;
+
+	//~ Begin FGCObject Interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override;
+	//~ End FGCObject Interface
+
+private:
+	static FBlueprintMessagePool* Instance;
+
+	/* Idle messages */
+	TArray<TObjectPtr<UBlueprintMessage>> FreeList;
+	/* Usage counters */
+	FBlueprintMessagePoolStats Stats;
+};
@@ -0,0 +1,170 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageQueue.h"
+#include "BlueprintMessage.h"
+#include "BlueprintMessageSettings.h"
+#include "BlueprintMessageSink.h"
+#include "BlueprintMessageTrace.h"
+#include "BlueprintMessageStats.h"
+#include "Logging/MessageLog.h"
+
+FBlueprintMessageQueue* FBlueprintMessageQueue::Instance = nullptr;
+
+namespace
+{
+	thread_local FBlueprintMessageQueue::FPendingBatch* GThreadStagingBuffer = nullptr;
+}
+
+FBlueprintMessageQueue::FBlueprintMessageQueue()
+{
+	check(Instance == nullptr);
+	Instance = this;
+
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FBlueprintMessageQueue::Tick));
+}
+
+FBlueprintMessageQueue::~FBlueprintMessageQueue()
+{
+	check(Instance == this);
+
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+	Flush();
+
+	if (!AsyncPending.IsEmpty())
+	{
+		UE_LOG(LogBlueprintMessage, Warning, TEXT("Messages submitted during shutdown were discarded"));
+	}
+
+	Instance = nullptr;
+}
+
+void FBlueprintMessageQueue::Enqueue(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage, bool bSuppressLoggingToOutputLog)
+{
+	check(IsInGameThread());
+
+	Pending.Add(FPendingMessage { InCategory, InMessage, bSuppressLoggingToOutputLog });
+
+	const int32 Threshold = UBlueprintMessageSettings::Get()->BatchFlushThreshold;
+	if (Threshold > 0 && Pending.Num() >= Threshold)
+	{
+		Flush();
+	}
+}
+
+void FBlueprintMessageQueue::EnqueueFromAnyThread(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage, bool bSuppressLoggingToOutputLog, uint32 InCallSiteId)
+{
+	if (FPendingBatch* Staging = FBlueprintMessageStagingScope::GetThreadBuffer())
+	{
+		Staging->Add(FPendingMessage { InCategory, InMessage, bSuppressLoggingToOutputLog, InCallSiteId });
+		return;
+	}
+
+	FPendingBatch Batch;
+	Batch.Add(FPendingMessage { InCategory, InMessage, bSuppressLoggingToOutputLog, InCallSiteId });
+	AsyncPending.Enqueue(MoveTemp(Batch));
+}
+
+void FBlueprintMessageQueue::DrainAsync()
+{
+	check(IsInGameThread());
+
+	FPendingBatch Batch;
+	while (AsyncPending.Dequeue(Batch))
+	{
+		for (const FPendingMessage& Item : Batch)
+		{
+			FBlueprintMessageStats::CountShown(Item.Category, Item.Message->GetSeverity(), Item.Message->GetMessageTokens().Num());
+			FBlueprintMessageTrace::OutputMessage(Item.Category, Item.Message, Item.CallSiteId);
+			FBlueprintMessageSinks::Dispatch(Item.Category, Item.Message, Item.CallSiteId);
+		}
+#if WITH_EDITOR
+		Pending.Append(MoveTemp(Batch));
+#endif
+		Batch.Reset();
+	}
+}
+
+void FBlueprintMessageQueue::Flush()
+{
+	check(IsInGameThread());
+
+	DrainAsync();
+
+	if (Pending.IsEmpty())
+	{
+		return;
+	}
+
+	// take ownership so messages shown while flushing go to next batch
+	TArray<FPendingMessage> Batch = MoveTemp(Pending);
+	Pending.Reset();
+
+	// group by category preserving order within each category, number of categories is expected to be small
+	struct FBatchGroup
+	{
+		FName Category;
+		bool bSuppressLoggingToOutputLog;
+		TArray<TSharedRef<FTokenizedMessage>> Messages;
+	};
+	TArray<FBatchGroup, TInlineAllocator<4>> Groups;
+
+	for (FPendingMessage& Item : Batch)
+	{
+		FBatchGroup* Group = Groups.FindByPredicate([&Item](const FBatchGroup& Other)
+		{
+			return Other.Category == Item.Category && Other.bSuppressLoggingToOutputLog == Item.bSuppressLoggingToOutputLog;
+		});
+		if (!Group)
+		{
+			Group = &Groups.Add_GetRef(FBatchGroup { Item.Category, Item.bSuppressLoggingToOutputLog });
+		}
+		Group->Messages.Add(MoveTemp(Item.Message));
+	}
+
+#if WITH_EDITOR
+	for (const FBatchGroup& Group : Groups)
+	{
+		FMessageLog Log(Group.Category);
+		Log.SuppressLoggingToOutputLog(Group.bSuppressLoggingToOutputLog);
+		Log.AddMessages(Group.Messages);
+		// ~FMessageLog() -> Log.Flush();
+	}
+#endif
+}
+
+bool FBlueprintMessageQueue::Tick(float DeltaTime)
+{
+	Flush();
+	return true;
+}
+
+FBlueprintMessageStagingScope::FBlueprintMessageStagingScope()
+{
+	// nested scopes share outermost buffer
+	if (!GThreadStagingBuffer)
+	{
+		GThreadStagingBuffer = &Buffer;
+		bOwnsBuffer = true;
+	}
+}
+
+FBlueprintMessageStagingScope::~FBlueprintMessageStagingScope()
+{
+	if (!bOwnsBuffer)
+	{
+		return;
+	}
+
+	GThreadStagingBuffer = nullptr;
+
+	FBlueprintMessageQueue* Queue = FBlueprintMessageQueue::Get();
+	if (Queue && Buffer.Num())
+	{
+		Queue->AsyncPending.Enqueue(MoveTemp(Buffer));
+	}
+}
+
+FBlueprintMessageQueue::FPendingBatch* FBlueprintMessageStagingScope::GetThreadBuffer()
+{
+	return GThreadStagingBuffer;
+}
@@ -0,0 +1,102 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "Logging/TokenizedMessage.h"
+
+/**
+ * Per-frame batched delivery of shown messages to the Message Log.
+ *
+ * Messages are queued on Show() and drained once per frame or when queue reaches size threshold,
+ * producing a single FMessageLog flush per category instead of one per message.
+ *
+ * Messages shown from worker threads are submitted through a lock-free multi-producer queue
+ * that is drained by the game thread. Submission order is preserved within each thread.
+ *
+ * Instance is owned by the module, delivery always happens on game thread.
+ */
+class BLUEPRINTMESSAGE_API FBlueprintMessageQueue
+{
+public:
+	FBlueprintMessageQueue();
+	~FBlueprintMessageQueue();
+
+	/** Get queue instance, null if module is not loaded */
+	static FBlueprintMessageQueue* Get() { return Instance; }
+
+	/**
+	 * Queue message for delivery. Game thread only.
+	 * @param InCategory message log category
+	 * @param InMessage message to deliver
+	 * @param bSuppressLoggingToOutputLog should message be mirrored to output log
+	 */
+	void Enqueue(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage, bool bSuppressLoggingToOutputLog);
+
+	/**
+	 * Queue message for delivery from any thread. Never blocks.
+	 * Message is delivered on game thread during next tick or explicit flush.
+	 * @param InCategory message log category
+	 * @param InMessage message to deliver, must not be accessed by caller after submission
+	 * @param bSuppressLoggingToOutputLog should message be mirrored to output log
+	 * @param InCallSiteId id of blueprint node that produced the message, 0 if unknown
+	 */
+	void EnqueueFromAnyThread(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage, bool bSuppressLoggingToOutputLog, uint32 InCallSiteId = 0);
+
+	/** Deliver all queued messages to the Message Log. Game thread only. */
+	void Flush();
+
+	/** Number of game thread messages waiting for delivery */
+	int32 Num() const { return Pending.Num(); }
+
+	struct FPendingMessage
+	{
+		FName Category;
+		TSharedRef<FTokenizedMessage> Message;
+		bool bSuppressLoggingToOutputLog;
+		uint32 CallSiteId = 0;
+	};
+
+	using FPendingBatch = TArray<FPendingMessage, TInlineAllocator<1>>;
+
+private:
+	friend class FBlueprintMessageStagingScope;
+
+	bool Tick(float DeltaTime);
+
+	/* Move messages submitted by other threads to pending list */
+	void DrainAsync();
+
+	static FBlueprintMessageQueue* Instance;
+
+	/* Messages waiting for delivery, in order of Show calls */
+	TArray<FPendingMessage> Pending;
+	/* Batches submitted from other threads */
+	TQueue<FPendingBatch, EQueueMode::Mpsc> AsyncPending;
+	/* Per frame flush */
+	FTSTicker::FDelegateHandle TickHandle;
+};
+
+/**
+ * Scope that collects messages shown by current thread in a thread-local staging buffer
+ * and submits them as a single batch when outermost scope ends.
+ *
+ * Useful for worker tasks emitting many messages, reducing contention on shared queue.
+ */
+class BLUEPRINTMESSAGE_API FBlueprintMessageStagingScope
+{
+public:
+	FBlueprintMessageStagingScope();
+	~FBlueprintMessageStagingScope();
+
+	UE_NONCOPYABLE(FBlueprintMessageStagingScope);
+
+	/** Get staging buffer of current thread, null if no scope is active */
+	static FBlueprintMessageQueue::FPendingBatch* GetThreadBuffer();
+
+private:
+	FBlueprintMessageQueue::FPendingBatch Buffer;
+	bool bOwnsBuffer = false;
+};
@@ -2,6 +2,7 @@
 #include "BlueprintMessageSettings.h"
 #include "BlueprintMessageToken.h"
 #include "BlueprintMessage.h"
+#include "BlueprintMessageSuppressor.h"
 #include "Modules/ModuleManager.h"
 #include "Misc/EngineVersionComparison.h"
 
@@ -127,6 +128,40 @@ TArray<FName> UBlueprintMessageSettings::GetGraphSelectableCategories() const
 	return OutCategories;
 }
 
+#if WITH_EDITOR
+void UBlueprintMessageSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// suppression windows are cached per category, edits apply without restart
+	if (PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(UBlueprintMessageSettings, CustomCategories))
+	{
+		if (FBlueprintMessageSuppressor* Suppressor = FBlueprintMessageSuppressor::Get())
+		{
+			Suppressor->RefreshSettings();
+		}
+	}
+}
+
+bool UBlueprintMessageSettings::IsStrippedFromGraph(const FName& InCategory, EBlueprintMessageSeverity InSeverity) const
+{
+	const bool bCooking = IsRunningCookCommandlet();
+	for (const FBlueprintMessageStripRule& Rule : GraphStripRules)
+	{
+		if (bCooking ? !Rule.bStripWhenCooking : !Rule.bStripInEditor)
+			continue;
+		if (!Rule.Category.IsNone() && Rule.Category != InCategory)
+			continue;
+		// lower value is more severe
+		if (static_cast<uint8>(InSeverity) > static_cast<uint8>(Rule.MinimumSeverity))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+#endif
+
 TArray<FName> UBlueprintMessageSettings::GetDiscoveredCategories() const
 {
 	TArray<FName> Result;
@@ -4,6 +4,7 @@
 #include "CoreMinimal.h"
 #include "UObject/SoftObjectPtr.h"
 #include "Engine/DeveloperSettings.h"
+#include "BlueprintMessageToken.h"
 #include "BlueprintMessageSettings.generated.h"
 
 /**
@@ -64,6 +65,45 @@ struct FBlueprintMessageLogCategory
 	/** Whether to scroll to the bottom of the window when messages are added */
 	UPROPERTY(EditAnywhere, Category=Advanced, meta=(EditCondition="bUseAdvancedSettings", EditConditionHides))
 	bool bScrollToBottom = false;
+
+	/**
+	 * Whether to count repeated messages within suppression window instead of showing them.
+	 * Unlike bDiscardDuplicates check happens before message is built and repeat count is shown when window closes.
+	 */
+	UPROPERTY(EditAnywhere, Category=Suppression)
+	bool bSuppressRepeats = false;
+
+	/** Duration of suppression window in seconds */
+	UPROPERTY(EditAnywhere, Category=Suppression, meta=(EditCondition="bSuppressRepeats", ClampMin=0, Units="s"))
+	float SuppressionWindow = 1.f;
+};
+
+/**
+ * Rule that removes messages from compiled blueprint graphs
+ */
+USTRUCT()
+struct FBlueprintMessageStripRule
+{
+	GENERATED_BODY()
+
+	/** Category this rule applies to. None applies rule to all categories. */
+	UPROPERTY(EditAnywhere, Category=General)
+	FName Category;
+
+	/** Messages less severe than this are removed */
+	UPROPERTY(EditAnywhere, Category=General)
+	EBlueprintMessageSeverity MinimumSeverity = EBlueprintMessageSeverity::Warning;
+
+	/**
+	 * Apply rule when blueprints are compiled by cooker.
+	 * Cooked bytecode is shared by Development, Test and Shipping targets.
+	 */
+	UPROPERTY(EditAnywhere, Category=General)
+	bool bStripWhenCooking = true;
+
+	/** Apply rule when blueprints are compiled in editor, useful to preview result of stripping */
+	UPROPERTY(EditAnywhere, Category=General)
+	bool bStripInEditor = false;
 };
 
 /**
@@ -87,6 +127,7 @@ public:
 #if WITH_EDITOR
 	virtual FText GetSectionText() const override { return INVTEXT("Blueprint Message Log"); }
 	virtual FText GetSectionDescription() const override { return INVTEXT("Message Log Blueprint integration plugin settings"); }
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 #endif
 
 	FName GetDefaultCategory() const;
@@ -105,6 +146,11 @@ public:
 	UFUNCTION()
 	TArray<FName> GetDiscoveredCategories() const;
 
+#if WITH_EDITOR
+	// Should message with literal category and severity be removed from graph being compiled
+	bool IsStrippedFromGraph(const FName& InCategory, EBlueprintMessageSeverity InSeverity) const;
+#endif
+
 private:
 	void DiscoverExistingCategories(TArray<FName>& OutCategories);
 
@@ -147,4 +193,111 @@ public:
 	UPROPERTY(Config, EditAnywhere, Category=Advanced)
 	bool bDefaultAutoDestroy = false;
 
+	// Enables recycling of message objects
+	// If enabled destroyed messages are reset and kept for reuse instead of being left to garbage collector
+	// Any references to destroyed message must not be used after Destroy
+	// Default is False
+	UPROPERTY(Config, EditAnywhere, Category=Pooling)
+	bool bEnableMessagePool = false;
+
+	// Maximum number of idle message objects kept by the pool
+	UPROPERTY(Config, EditAnywhere, Category=Pooling, meta=(EditCondition="bEnableMessagePool", ClampMin=0))
+	int32 MessagePoolSize = 128;
+
+	// Share token instances for repeated text, name and image values when messages are built
+	// Default is True
+	UPROPERTY(Config, EditAnywhere, Category=Pooling, meta=(ConfigRestartRequired=true))
+	bool bInternTokens = true;
+
+	// Number of most recently used tokens of each kind kept for sharing
+	UPROPERTY(Config, EditAnywhere, Category=Pooling, meta=(EditCondition="bInternTokens", ClampMin=1, ConfigRestartRequired=true))
+	int32 TokenCacheSize = 256;
+
+	// Add Text Token nodes capture arguments and format text only when message is rendered
+	// Applies to all nodes regardless of their own setting, requires blueprint recompile
+	// Default is False
+	UPROPERTY(Config, EditAnywhere, Category=Graph)
+	bool bDeferTextTokenFormatting = false;
+
+	// Rules that remove messages from compiled graphs, requires blueprint recompile
+	// Only messages with literal category and severity whose object does not leave Add Token / Show chain are removed
+	// Removed message nodes expand to nothing: no message object, no token factories and no Format calls
+	UPROPERTY(Config, EditAnywhere, Category=Graph)
+	TArray<FBlueprintMessageStripRule> GraphStripRules;
+
+	// Create Message nodes branch over whole message chain on Is Message Category Enabled
+	// Messages disabled with BlueprintMessage.* console variables then skip building tokens, requires blueprint recompile
+	// Default is True
+	UPROPERTY(Config, EditAnywhere, Category=Graph)
+	bool bGateMessagesAtRuntime = true;
+
+	// Enables batched delivery of shown messages
+	// If enabled messages are queued and delivered to Message Log once per frame with one flush per category
+	// Default is False
+	UPROPERTY(Config, EditAnywhere, Category=Delivery)
+	bool bBatchMessageDelivery = false;
+
+	// Number of queued messages that triggers immediate delivery, 0 to deliver only once per frame
+	UPROPERTY(Config, EditAnywhere, Category=Delivery, meta=(EditCondition="bBatchMessageDelivery", ClampMin=0))
+	int32 BatchFlushThreshold = 256;
+
+	// Enables default runtime sink that writes shown messages to output log and/or a file
+	// Runtime sinks are active in builds without editor where Message Log is not available, Shipping requires bRuntimeSinkInShipping
+	// Default is True
+	UPROPERTY(Config, EditAnywhere, Category=Runtime, meta=(ConfigRestartRequired=true))
+	bool bEnableRuntimeSink = true;
+
+	// Also use default runtime sink in editor builds
+	UPROPERTY(Config, EditAnywhere, Category=Runtime, meta=(EditCondition="bEnableRuntimeSink", ConfigRestartRequired=true))
+	bool bRuntimeSinkInEditor = false;
+
+	// Also use default runtime sink in Shipping builds, every shown message is then rendered and written
+	// Default is False
+	UPROPERTY(Config, EditAnywhere, Category=Runtime, meta=(EditCondition="bEnableRuntimeSink", ConfigRestartRequired=true))
+	bool bRuntimeSinkInShipping = false;
+
+	// Should runtime sink write messages to output log
+	UPROPERTY(Config, EditAnywhere, Category=Runtime, meta=(EditCondition="bEnableRuntimeSink", ConfigRestartRequired=true))
+	bool bRuntimeSinkWriteToLog = true;
+
+	// File to append messages to, relative paths are resolved against project log directory
+	// No file is written if empty
+	UPROPERTY(Config, EditAnywhere, Category=Runtime, meta=(EditCondition="bEnableRuntimeSink", ConfigRestartRequired=true))
+	FString RuntimeSinkFilePath;
+
+	// Write shown messages to binary file preserving token structure
+	// Default is False
+	UPROPERTY(Config, EditAnywhere, Category=Runtime, meta=(ConfigRestartRequired=true))
+	bool bEnableBinarySink = false;
+
+	// Binary file to write messages to, relative paths are resolved against project log directory
+	// New file is started each run, file from previous run is kept with backup timestamp suffix
+	UPROPERTY(Config, EditAnywhere, Category=Runtime, meta=(EditCondition="bEnableBinarySink", ConfigRestartRequired=true))
+	FString BinarySinkFilePath = TEXT("BlueprintMessages.bpmlog");
+
+	// Number of bytes accumulated in memory before they are written to binary file
+	UPROPERTY(Config, EditAnywhere, Category=Runtime, meta=(EditCondition="bEnableBinarySink", ClampMin=1024, ConfigRestartRequired=true))
+	int32 BinarySinkBufferSize = 65536;
+
+	// Keep last shown messages in memory for queries from game code
+	// History holds shown messages and makes every message be built even when nothing else consumes it
+	// Shipping builds additionally require bMessageHistoryInShipping
+	// Default is False
+	UPROPERTY(Config, EditAnywhere, Category=History, meta=(ConfigRestartRequired=true))
+	bool bEnableMessageHistory = false;
+
+	// Also keep message history in Shipping builds, history holds references to shown messages and their tokens
+	// Default is False
+	UPROPERTY(Config, EditAnywhere, Category=History, meta=(EditCondition="bEnableMessageHistory", ConfigRestartRequired=true))
+	bool bMessageHistoryInShipping = false;
+
+	// Number of last shown messages kept in history
+	UPROPERTY(Config, EditAnywhere, Category=History, meta=(EditCondition="bEnableMessageHistory", ClampMin=1, ConfigRestartRequired=true))
+	int32 MessageHistoryCapacity = 1024;
+
+	// Maintain search index over message history for text and object reference lookups
+	// Default is False
+	UPROPERTY(Config, EditAnywhere, Category=History, meta=(EditCondition="bEnableMessageHistory", ConfigRestartRequired=true))
+	bool bEnableMessageHistoryIndex = false;
+
 };
@@ -0,0 +1,49 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageSink.h"
+
+TArray<TSharedRef<IBlueprintMessageSink>> FBlueprintMessageSinks::Sinks;
+std::atomic<int32> FBlueprintMessageSinks::NumSinks { 0 };
+uint32 FBlueprintMessageSinks::DispatchCallSiteId = 0;
+
+void FBlueprintMessageSinks::Register(const TSharedRef<IBlueprintMessageSink>& InSink)
+{
+	check(IsInGameThread());
+
+	Sinks.AddUnique(InSink);
+	NumSinks.store(Sinks.Num(), std::memory_order_relaxed);
+}
+
+void FBlueprintMessageSinks::Unregister(const TSharedRef<IBlueprintMessageSink>& InSink)
+{
+	check(IsInGameThread());
+
+	if (Sinks.Remove(InSink) > 0)
+	{
+		InSink->Flush();
+	}
+	NumSinks.store(Sinks.Num(), std::memory_order_relaxed);
+}
+
+void FBlueprintMessageSinks::Dispatch(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage, uint32 InCallSiteId)
+{
+	check(IsInGameThread());
+
+	// exposed to sinks without changing sink interface
+	TGuardValue<uint32> CallSiteGuard(DispatchCallSiteId, InCallSiteId);
+
+	for (const TSharedRef<IBlueprintMessageSink>& Sink : Sinks)
+	{
+		Sink->ReceiveMessage(InCategory, InMessage);
+	}
+}
+
+void FBlueprintMessageSinks::FlushAll()
+{
+	check(IsInGameThread());
+
+	for (const TSharedRef<IBlueprintMessageSink>& Sink : Sinks)
+	{
+		Sink->Flush();
+	}
+}
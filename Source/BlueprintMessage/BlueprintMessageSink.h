@@ -0,0 +1,58 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Logging/TokenizedMessage.h"
+
+/**
+ * Receiver of shown messages independent of editor Message Log.
+ *
+ * Sinks are active in all build configurations, including packaged builds without editor.
+ * Messages are delivered on game thread in order they were shown.
+ */
+class BLUEPRINTMESSAGE_API IBlueprintMessageSink
+{
+public:
+	virtual ~IBlueprintMessageSink() = default;
+
+	/**
+	 * Receive shown message.
+	 * @param InCategory message log category
+	 * @param InMessage built message, shared with other sinks and must not be modified
+	 */
+	virtual void ReceiveMessage(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage) = 0;
+
+	/** Write any buffered data */
+	virtual void Flush() { }
+};
+
+/**
+ * Registry of active message sinks.
+ */
+class BLUEPRINTMESSAGE_API FBlueprintMessageSinks
+{
+public:
+	/** Register sink to receive shown messages. Game thread only. */
+	static void Register(const TSharedRef<IBlueprintMessageSink>& InSink);
+
+	/** Unregister previously registered sink. Game thread only. */
+	static void Unregister(const TSharedRef<IBlueprintMessageSink>& InSink);
+
+	/** Are there any sinks registered, can be called from any thread */
+	static bool HasSinks() { return NumSinks.load(std::memory_order_relaxed) > 0; }
+
+	/** Deliver message to all registered sinks. Game thread only. */
+	static void Dispatch(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage, uint32 InCallSiteId = 0);
+
+	/** Id of blueprint node that produced message currently being delivered, 0 if unknown. Game thread only. */
+	static uint32 GetDispatchCallSiteId() { return DispatchCallSiteId; }
+
+	/** Flush all registered sinks. Game thread only. */
+	static void FlushAll();
+
+private:
+	static TArray<TSharedRef<IBlueprintMessageSink>> Sinks;
+	static std::atomic<int32> NumSinks;
+	static uint32 DispatchCallSiteId;
+};
@@ -0,0 +1,66 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageStats.h"
+
+DEFINE_STAT(STAT_BlueprintMessage_Create);
+DEFINE_STAT(STAT_BlueprintMessage_Build);
+DEFINE_STAT(STAT_BlueprintMessage_Show);
+DEFINE_STAT(STAT_BlueprintMessage_ShowAndPrint);
+
+DEFINE_STAT(STAT_BlueprintMessage_NumShown);
+DEFINE_STAT(STAT_BlueprintMessage_NumErrors);
+DEFINE_STAT(STAT_BlueprintMessage_NumWarnings);
+DEFINE_STAT(STAT_BlueprintMessage_NumInfos);
+DEFINE_STAT(STAT_BlueprintMessage_NumTokensShown);
+DEFINE_STAT(STAT_BlueprintMessage_MaxTokensPerMessage);
+DEFINE_STAT(STAT_BlueprintMessage_NumLive);
+
+DEFINE_STAT(STAT_BlueprintMessage_TokenMemory);
+
+void FBlueprintMessageStats::CountShown(const FName& InCategory, EMessageSeverity::Type InSeverity, int32 InNumTokens)
+{
+#if STATS
+	INC_DWORD_STAT(STAT_BlueprintMessage_NumShown);
+	INC_DWORD_STAT_BY(STAT_BlueprintMessage_NumTokensShown, InNumTokens);
+
+	switch (InSeverity)
+	{
+	case EMessageSeverity::CriticalError:
+	case EMessageSeverity::Error:
+		INC_DWORD_STAT(STAT_BlueprintMessage_NumErrors);
+		break;
+	case EMessageSeverity::Warning:
+	case EMessageSeverity::PerformanceWarning:
+		INC_DWORD_STAT(STAT_BlueprintMessage_NumWarnings);
+		break;
+	default:
+		INC_DWORD_STAT(STAT_BlueprintMessage_NumInfos);
+		break;
+	}
+
+	// categories are only known at runtime, counters are created on first use
+	check(IsInGameThread());
+
+	// counter is cleared every frame, so maximum restarts with each frame
+	static uint64 MaxTokensFrame = 0;
+	static int32 MaxTokens = 0;
+	if (MaxTokensFrame != GFrameCounter)
+	{
+		MaxTokensFrame = GFrameCounter;
+		MaxTokens = 0;
+	}
+	if (InNumTokens > MaxTokens)
+	{
+		MaxTokens = InNumTokens;
+		SET_DWORD_STAT(STAT_BlueprintMessage_MaxTokensPerMessage, MaxTokens);
+	}
+	static TMap<FName, TStatId> CategoryStats;
+	TStatId* StatId = CategoryStats.Find(InCategory);
+	if (!StatId)
+	{
+		StatId = &CategoryStats.Add(InCategory, FDynamicStats::CreateStatIdInt64<FStatGroup_STATGROUP_BlueprintMessage>(
+			FString::Printf(TEXT("Messages Shown (%s)"), *InCategory.ToString())));
+	}
+	INC_DWORD_STAT_FNAME_BY(StatId->GetName(), 1);
+#endif
+}
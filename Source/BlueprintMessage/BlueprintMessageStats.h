@@ -0,0 +1,33 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Logging/TokenizedMessage.h"
+
+DECLARE_STATS_GROUP(TEXT("BlueprintMessage"), STATGROUP_BlueprintMessage, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Create Message"), STAT_BlueprintMessage_Create, STATGROUP_BlueprintMessage, BLUEPRINTMESSAGE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Build Message"), STAT_BlueprintMessage_Build, STATGROUP_BlueprintMessage, BLUEPRINTMESSAGE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Show Message"), STAT_BlueprintMessage_Show, STATGROUP_BlueprintMessage, BLUEPRINTMESSAGE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Show And Print Message"), STAT_BlueprintMessage_ShowAndPrint, STATGROUP_BlueprintMessage, BLUEPRINTMESSAGE_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Messages Shown"), STAT_BlueprintMessage_NumShown, STATGROUP_BlueprintMessage, BLUEPRINTMESSAGE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Errors Shown"), STAT_BlueprintMessage_NumErrors, STATGROUP_BlueprintMessage, BLUEPRINTMESSAGE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Warnings Shown"), STAT_BlueprintMessage_NumWarnings, STATGROUP_BlueprintMessage, BLUEPRINTMESSAGE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Infos Shown"), STAT_BlueprintMessage_NumInfos, STATGROUP_BlueprintMessage, BLUEPRINTMESSAGE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Tokens Shown"), STAT_BlueprintMessage_NumTokensShown, STATGROUP_BlueprintMessage, BLUEPRINTMESSAGE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Max Tokens Per Message"), STAT_BlueprintMessage_MaxTokensPerMessage, STATGROUP_BlueprintMessage, BLUEPRINTMESSAGE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live Messages"), STAT_BlueprintMessage_NumLive, STATGROUP_BlueprintMessage, BLUEPRINTMESSAGE_API);
+
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Token Storage"), STAT_BlueprintMessage_TokenMemory, STATGROUP_BlueprintMessage, BLUEPRINTMESSAGE_API);
+
+/**
+ * Helpers for stats that can not be expressed with static declarations
+ */
+struct FBlueprintMessageStats
+{
+	/** Count shown message in severity, per category and token counters */
+	static void CountShown(const FName& InCategory, EMessageSeverity::Type InSeverity, int32 InNumTokens);
+};
@@ -0,0 +1,185 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageSuppressor.h"
+#include "BlueprintMessage.h"
+#include "BlueprintMessageSettings.h"
+#include "Misc/ScopeLock.h"
+#include "Hash/CityHash.h"
+
+FBlueprintMessageSuppressor* FBlueprintMessageSuppressor::Instance = nullptr;
+
+FBlueprintMessageSuppressor::FBlueprintMessageSuppressor()
+{
+	check(Instance == nullptr);
+	Instance = this;
+
+	RefreshSettings();
+
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FBlueprintMessageSuppressor::Tick));
+}
+
+FBlueprintMessageSuppressor::~FBlueprintMessageSuppressor()
+{
+	check(Instance == this);
+
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+	Flush();
+
+	Instance = nullptr;
+}
+
+void FBlueprintMessageSuppressor::RefreshSettings()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	CategoryWindows.Reset();
+	for (const FBlueprintMessageLogCategory& Category : UBlueprintMessageSettings::Get()->CustomCategories)
+	{
+		if (!Category.Name.IsNone() && Category.bSuppressRepeats && Category.SuppressionWindow > 0.f)
+		{
+			CategoryWindows.Add(Category.Name, Category.SuppressionWindow);
+		}
+	}
+}
+
+uint64 FBlueprintMessageSuppressor::FingerprintMessage(const FText& InInitialMessage, const TArray<FBlueprintMessageToken>& InTokens)
+{
+	uint64 Hash = 0;
+	auto HashString = [&Hash](const FString& InString)
+	{
+		Hash = CityHash64WithSeed(reinterpret_cast<const char*>(*InString), InString.Len() * sizeof(TCHAR), Hash);
+	};
+	auto HashValue = [&Hash](const auto& InValue)
+	{
+		Hash = CityHash64WithSeed(reinterpret_cast<const char*>(&InValue), sizeof(InValue), Hash);
+	};
+
+	HashString(InInitialMessage.ToString());
+
+	for (const FBlueprintMessageToken& Token : InTokens)
+	{
+		const EBlueprintMessageTokenKind Kind = Token.GetKind();
+		HashValue(Kind);
+		HashValue(GetTypeHash(Token.GetName()));
+
+		switch (Kind)
+		{
+		case EBlueprintMessageTokenKind::Text:
+			HashString(Token.GetPayload<FBlueprintMessageTextPayload>()->Text.ToString());
+			break;
+		case EBlueprintMessageTokenKind::Name:
+			HashValue(GetTypeHash(Token.GetPayload<FBlueprintMessageNamePayload>()->Name));
+			break;
+		case EBlueprintMessageTokenKind::URL:
+			HashString(Token.GetPayload<FBlueprintMessageUrlPayload>()->Url);
+			HashString(Token.GetPayload<FBlueprintMessageUrlPayload>()->Label.ToString());
+			break;
+		case EBlueprintMessageTokenKind::AssetName:
+			HashString(Token.GetPayload<FBlueprintMessageAssetNamePayload>()->AssetPath);
+			HashString(Token.GetPayload<FBlueprintMessageAssetNamePayload>()->Label.ToString());
+			break;
+		case EBlueprintMessageTokenKind::Actor:
+			HashString(Token.GetPayload<FBlueprintMessageActorPayload>()->ActorPath);
+			HashValue(Token.GetPayload<FBlueprintMessageActorPayload>()->Guid);
+			HashString(Token.GetPayload<FBlueprintMessageActorPayload>()->Label.ToString());
+			break;
+		case EBlueprintMessageTokenKind::Image:
+			HashValue(GetTypeHash(Token.GetPayload<FBlueprintMessageImagePayload>()->ImageName));
+			break;
+		case EBlueprintMessageTokenKind::Timestamp:
+			// captured time differs for every repeat, only format is part of identity
+			HashValue(Token.GetPayload<FBlueprintMessageTimestampPayload>()->Type);
+			HashValue(Token.GetPayload<FBlueprintMessageTimestampPayload>()->bIncludeFrame);
+			break;
+		case EBlueprintMessageTokenKind::Action:
+			HashString(Token.GetPayload<FBlueprintMessageActionPayload>()->Name.ToString());
+			HashString(Token.GetPayload<FBlueprintMessageActionPayload>()->Description.ToString());
+			break;
+		default:
+			if (Token.GetInstanceHash() != 0)
+			{
+				HashValue(Token.GetInstanceHash());
+			}
+			else if (Token.HasContent())
+			{
+				HashValue(Token.GetType());
+				HashString(Token.ToText().ToString());
+			}
+			break;
+		}
+	}
+	return Hash;
+}
+
+bool FBlueprintMessageSuppressor::ShouldSuppress(const FName& InCategory, EBlueprintMessageSeverity InSeverity, const FText& InInitialMessage, const TArray<FBlueprintMessageToken>& InTokens, bool bInSuppressLoggingToOutputLog, uint32 InCallSiteId)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	const double* WindowDuration = CategoryWindows.Find(InCategory);
+	if (!WindowDuration)
+	{
+		return false;
+	}
+
+	const FWindowKey Key { InCategory, InSeverity, FingerprintMessage(InInitialMessage, InTokens) };
+	if (FWindow* Existing = Windows.Find(Key))
+	{
+		++Existing->Count;
+		return true;
+	}
+
+	FWindow& Window = Windows.Add(Key);
+	Window.CloseTime = FPlatformTime::Seconds() + *WindowDuration;
+	Window.Category = InCategory;
+	Window.Severity = InSeverity;
+	Window.InitialMessage = InInitialMessage;
+	Window.Tokens = InTokens;
+	Window.bSuppressLoggingToOutputLog = bInSuppressLoggingToOutputLog;
+	Window.CallSiteId = InCallSiteId;
+	return false;
+}
+
+bool FBlueprintMessageSuppressor::IsCategorySuppressed(const FName& InCategory) const
+{
+	FScopeLock ScopeLock(&Lock);
+	return CategoryWindows.Contains(InCategory);
+}
+
+void FBlueprintMessageSuppressor::Flush()
+{
+	CloseWindows(FPlatformTime::Seconds(), true);
+}
+
+bool FBlueprintMessageSuppressor::Tick(float DeltaTime)
+{
+	CloseWindows(FPlatformTime::Seconds(), false);
+	return true;
+}
+
+void FBlueprintMessageSuppressor::CloseWindows(double Now, bool bForce)
+{
+	TArray<FWindow, TInlineAllocator<8>> Closed;
+	{
+		FScopeLock ScopeLock(&Lock);
+		for (auto It = Windows.CreateIterator(); It; ++It)
+		{
+			if (bForce || It->Value.CloseTime <= Now)
+			{
+				if (It->Value.Count > 0)
+				{
+					Closed.Add(MoveTemp(It->Value));
+				}
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	// show outside of lock, message delivery may re-enter suppressor
+	for (FWindow& Window : Closed)
+	{
+		Window.Tokens.Add(FBlueprintMessageToken(FTextToken::Create(FText::FromString(FString::Printf(TEXT("(×%d)"), Window.Count)))));
+
+		UBlueprintMessage::FTagToMessage TagToMessage = UBlueprintMessage::BuildMessage(Window.Category, Window.Severity, Window.InitialMessage, Window.Tokens);
+		UBlueprintMessage::ShowImpl(TagToMessage.Key, TagToMessage.Value, Window.bSuppressLoggingToOutputLog, Window.CallSiteId);
+	}
+}
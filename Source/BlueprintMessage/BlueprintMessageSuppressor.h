@@ -0,0 +1,92 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "BlueprintMessageToken.h"
+
+/**
+ * Early per-category suppression of repeated messages.
+ *
+ * Message identity is category, severity and a 64-bit fingerprint of initial text and token payloads.
+ * Tokens are not rendered, deferred format tokens contribute pattern and arguments and timestamps only their format.
+ * Repeats within configured window are counted instead of being built and shown,
+ * and a single copy with occurrence counter is shown when window closes.
+ *
+ * Instance is owned by the module, can be used from any thread.
+ */
+class BLUEPRINTMESSAGE_API FBlueprintMessageSuppressor
+{
+public:
+	FBlueprintMessageSuppressor();
+	~FBlueprintMessageSuppressor();
+
+	/** Get suppressor instance, null if module is not loaded */
+	static FBlueprintMessageSuppressor* Get() { return Instance; }
+
+	/**
+	 * Register message occurrence.
+	 * @return true if message is a repeat and should not be shown
+	 */
+	bool ShouldSuppress(const FName& InCategory, EBlueprintMessageSeverity InSeverity, const FText& InInitialMessage, const TArray<FBlueprintMessageToken>& InTokens, bool bInSuppressLoggingToOutputLog, uint32 InCallSiteId = 0);
+
+	/** Are repeats suppressed in category, lets callers skip collecting tokens for ShouldSuppress */
+	bool IsCategorySuppressed(const FName& InCategory) const;
+
+	/** Close all open windows emitting occurrence counters */
+	void Flush();
+
+	/** Rebuild per category settings cache */
+	void RefreshSettings();
+
+private:
+	bool Tick(float DeltaTime);
+
+	/* Close windows that expired before specified time */
+	void CloseWindows(double Now, bool bForce);
+
+	static uint64 FingerprintMessage(const FText& InInitialMessage, const TArray<FBlueprintMessageToken>& InTokens);
+
+	static FBlueprintMessageSuppressor* Instance;
+
+	struct FWindowKey
+	{
+		FName Category;
+		EBlueprintMessageSeverity Severity = EBlueprintMessageSeverity::Info;
+		uint64 Fingerprint = 0;
+
+		bool operator==(const FWindowKey& Other) const
+		{
+			return Fingerprint == Other.Fingerprint && Severity == Other.Severity && Category == Other.Category;
+		}
+
+		friend uint32 GetTypeHash(const FWindowKey& Key)
+		{
+			return HashCombine(GetTypeHash(Key.Category), static_cast<uint32>(Key.Fingerprint));
+		}
+	};
+
+	struct FWindow
+	{
+		/* Time window closes at */
+		double CloseTime = 0;
+		/* Number of suppressed repeats */
+		int32 Count = 0;
+		/* Message state captured at first occurrence */
+		FName Category;
+		EBlueprintMessageSeverity Severity = EBlueprintMessageSeverity::Info;
+		FText InitialMessage;
+		TArray<FBlueprintMessageToken> Tokens;
+		bool bSuppressLoggingToOutputLog = false;
+		uint32 CallSiteId = 0;
+	};
+
+	mutable FCriticalSection Lock;
+	/* Open windows by message identity */
+	TMap<FWindowKey, FWindow> Windows;
+	/* Suppression window duration for categories with suppression enabled */
+	TMap<FName, double> CategoryWindows;
+	/* Periodic window expiration */
+	FTSTicker::FDelegateHandle TickHandle;
+};
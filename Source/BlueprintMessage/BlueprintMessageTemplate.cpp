@@ -0,0 +1,217 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageTemplate.h"
+#include "BlueprintMessage.h"
+#include "BlueprintMessageCategoryGate.h"
+#include "BlueprintMessageSettings.h"
+#include "BlueprintMessageSuppressor.h"
+#include "BlueprintMessageTimestampToken.h"
+
+FBlueprintMessageTemplate FBlueprintMessageTemplate::Compile(FName InCategory, EBlueprintMessageSeverity InSeverity, const FText& InMessage, const TArray<FBlueprintMessageToken>& InTokens)
+{
+	TSharedRef<FBlueprintMessageTemplateLayout> NewLayout = MakeShared<FBlueprintMessageTemplateLayout>();
+	NewLayout->Tokens.Reserve(InTokens.Num());
+	NewLayout->TokenSlots.Reserve(InTokens.Num());
+
+	// is default of each slot a timestamp
+	TBitArray<> TimestampSlots;
+
+	for (const FBlueprintMessageToken& Token : InTokens)
+	{
+		const bool bTimestamp = Token.GetKind() == EBlueprintMessageTokenKind::Timestamp;
+
+		const FName& SlotName = Token.GetName();
+		if (SlotName.IsNone())
+		{
+			if (TSharedPtr<IMessageToken> Instance = Token.GetToken())
+			{
+				NewLayout->Tokens.Add(Instance.ToSharedRef());
+				NewLayout->TokenSlots.Add(INDEX_NONE);
+				NewLayout->TimestampTokens.Add(bTimestamp);
+			}
+			continue;
+		}
+
+		int32 SlotIndex = NewLayout->SlotNames.Find(SlotName);
+		if (SlotIndex == INDEX_NONE)
+		{
+			SlotIndex = NewLayout->SlotNames.Add(SlotName);
+
+			TSharedPtr<IMessageToken> Default = Token.GetToken();
+			NewLayout->SlotDefaults.Add(Default.IsValid() ? Default.ToSharedRef() : UBlueprintMessage::GetSlotPlaceholder(SlotName));
+			TimestampSlots.Add(bTimestamp && Default.IsValid());
+		}
+
+		// slot positions in token stream are taken by slot default until filled
+		NewLayout->Tokens.Add(NewLayout->SlotDefaults[SlotIndex]);
+		NewLayout->TokenSlots.Add(SlotIndex);
+		NewLayout->TimestampTokens.Add(TimestampSlots[SlotIndex]);
+	}
+
+	FBlueprintMessageTemplate Result;
+	Result.Category = InCategory.IsNone() ? UBlueprintMessageSettings::Get()->GetDefaultCategory() : InCategory;
+	Result.Severity = InSeverity;
+	Result.InitialMessage = InMessage;
+	Result.CategoryHandle = FBlueprintMessageCategoryGate::GetCategoryHandle(Result.Category);
+	Result.Layout = NewLayout;
+	return Result;
+}
+
+int32 FBlueprintMessageTemplate::FindSlot(FName Name) const
+{
+	return Layout.IsValid() ? Layout->SlotNames.Find(Name) : INDEX_NONE;
+}
+
+FBlueprintMessageTemplateInstance::FBlueprintMessageTemplateInstance(const FBlueprintMessageTemplate& InTemplate)
+	: Template(InTemplate), Severity(InTemplate.Severity), CallSiteId(InTemplate.CallSiteId)
+{
+	SlotValues.SetNum(InTemplate.GetNumSlots());
+	SlotTokens.SetNum(InTemplate.GetNumSlots());
+	bSuppressLoggingToOutputLog = UBlueprintMessageSettings::Get()->bDefaultSuppressLoggingToOutputLog;
+}
+
+FBlueprintMessageTemplateInstance& FBlueprintMessageTemplateInstance::FillSlot(int32 SlotIndex, const FBlueprintMessageToken& Token)
+{
+	if (SlotValues.IsValidIndex(SlotIndex))
+	{
+		SlotValues[SlotIndex] = Token.GetToken();
+		SlotTokens[SlotIndex] = Token;
+	}
+	else
+	{
+		UE_LOG(LogBlueprintMessage, Warning, TEXT("Attempt to fill invalid template slot %d"), SlotIndex);
+	}
+	return *this;
+}
+
+FBlueprintMessageTemplateInstance& FBlueprintMessageTemplateInstance::FillSlot(FName Name, const FBlueprintMessageToken& Token)
+{
+	const int32 SlotIndex = Template.FindSlot(Name);
+	if (SlotIndex == INDEX_NONE)
+	{
+		UE_LOG(LogBlueprintMessage, Warning, TEXT("Attempt to fill unknown template slot %s"), *Name.ToString());
+		return *this;
+	}
+	return FillSlot(SlotIndex, Token);
+}
+
+FBlueprintMessageTemplateInstance& FBlueprintMessageTemplateInstance::SetSeverity(EBlueprintMessageSeverity InSeverity)
+{
+	Severity = InSeverity;
+	return *this;
+}
+
+FBlueprintMessageTemplateInstance& FBlueprintMessageTemplateInstance::SetCallSiteId(uint32 InCallSiteId)
+{
+	CallSiteId = InCallSiteId;
+	return *this;
+}
+
+void FBlueprintMessageTemplateInstance::CollectTokens(TArray<FBlueprintMessageToken>& OutTokens) const
+{
+	const FBlueprintMessageTemplateLayout& Layout = *Template.Layout;
+
+	OutTokens.Reserve(Layout.Tokens.Num());
+	for (int32 Index = 0; Index < Layout.Tokens.Num(); ++Index)
+	{
+		const int32 SlotIndex = Layout.TokenSlots[Index];
+		if (SlotIndex != INDEX_NONE && SlotValues[SlotIndex].IsValid())
+		{
+			OutTokens.Add(SlotTokens[SlotIndex]);
+		}
+		else
+		{
+			// layout tokens are immutable and shared by all instances, address is enough to tell them apart
+			FBlueprintMessageToken& Token = OutTokens.Emplace_GetRef(CopyTemp(Layout.Tokens[Index]));
+			Token.SetInstanceHash(reinterpret_cast<UPTRINT>(&Layout.Tokens[Index].Get()));
+		}
+	}
+}
+
+void FBlueprintMessageTemplateInstance::Show() const
+{
+	if (!Template.IsValid())
+	{
+		UE_LOG(LogBlueprintMessage, Warning, TEXT("Attempt to show message from invalid template"));
+		return;
+	}
+
+	if (!UBlueprintMessage::HasMessageConsumers()
+		|| !FBlueprintMessageCategoryGate::IsEnabled(Template.CategoryHandle, Severity))
+	{
+		return;
+	}
+
+	const FBlueprintMessageSuppressor* Suppressor = FBlueprintMessageSuppressor::Get();
+	if (Suppressor && Suppressor->IsCategorySuppressed(Template.Category))
+	{
+		TArray<FBlueprintMessageToken> Tokens;
+		CollectTokens(Tokens);
+		if (UBlueprintMessage::IsRepeatSuppressed(Template.Category, Severity, Template.InitialMessage, Tokens, bSuppressLoggingToOutputLog, CallSiteId))
+		{
+			return;
+		}
+	}
+
+	const FBlueprintMessageTemplateLayout& Layout = *Template.Layout;
+
+	TSharedRef<FTokenizedMessage> MessagePtr = FTokenizedMessage::Create(static_cast<EMessageSeverity::Type>(Severity), Template.InitialMessage);
+	for (int32 Index = 0; Index < Layout.Tokens.Num(); ++Index)
+	{
+		const int32 SlotIndex = Layout.TokenSlots[Index];
+		if (SlotIndex != INDEX_NONE && SlotValues[SlotIndex].IsValid())
+		{
+			MessagePtr->AddToken(SlotValues[SlotIndex].ToSharedRef());
+		}
+		else if (Layout.TimestampTokens[Index])
+		{
+			// compiled timestamp only carries format, time is that of this show
+			const FBlueprintMessageTimestampToken& Compiled = static_cast<const FBlueprintMessageTimestampToken&>(Layout.Tokens[Index].Get());
+			MessagePtr->AddToken(FBlueprintMessageTimestampToken::Create(Compiled.GetTimestampType(), Compiled.IncludesFrame()));
+		}
+		else
+		{
+			MessagePtr->AddToken(Layout.Tokens[Index]);
+		}
+	}
+
+	UBlueprintMessage::ShowImpl(Template.Category, MessagePtr, bSuppressLoggingToOutputLog, CallSiteId);
+}
+
+FBlueprintMessageTemplate UBlueprintMessageTemplateLibrary::CompileMessageTemplate(UBlueprintMessage* Prototype)
+{
+	if (!IsValid(Prototype))
+	{
+		UE_LOG(LogBlueprintMessage, Warning, TEXT("Attempt to compile message template from invalid message"));
+		return FBlueprintMessageTemplate();
+	}
+
+	FBlueprintMessageTemplate Result = FBlueprintMessageTemplate::Compile(Prototype->Category, Prototype->Severity, Prototype->InitialMessage, Prototype->Tokens);
+	Result.CallSiteId = Prototype->CallSiteId;
+	return Result;
+}
+
+int32 UBlueprintMessageTemplateLibrary::FindTemplateSlot(const FBlueprintMessageTemplate& Template, FName Slot)
+{
+	return Template.FindSlot(Slot);
+}
+
+FBlueprintMessageTemplateInstance UBlueprintMessageTemplateLibrary::CreateFromTemplate(const FBlueprintMessageTemplate& Template)
+{
+	return FBlueprintMessageTemplateInstance(Template);
+}
+
+void UBlueprintMessageTemplateLibrary::FillTemplateSlot(FBlueprintMessageTemplateInstance& Message, int32 SlotIndex, const FBlueprintMessageToken& Token)
+{
+	Message.FillSlot(SlotIndex, Token);
+}
+
+void UBlueprintMessageTemplateLibrary::FillTemplateSlotByName(FBlueprintMessageTemplateInstance& Message, FName Slot, const FBlueprintMessageToken& Token)
+{
+	Message.FillSlot(Slot, Token);
+}
+
+void UBlueprintMessageTemplateLibrary::ShowTemplateMessage(const FBlueprintMessageTemplateInstance& Message)
+{
+	Message.Show();
+}
@@ -0,0 +1,177 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlueprintMessageToken.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "BlueprintMessageTemplate.generated.h"
+
+class UBlueprintMessage;
+
+/**
+ * Immutable token layout shared between template and all its instances
+ */
+struct FBlueprintMessageTemplateLayout
+{
+	/* Token stream, static tokens are shared as is */
+	TArray<TSharedRef<IMessageToken>> Tokens;
+	/* Slot index for each token or INDEX_NONE for static token */
+	TArray<int32> TokenSlots;
+	/* Tokens that are timestamps, recaptured each time message is shown */
+	TBitArray<> TimestampTokens;
+	/* Unique slot names */
+	TArray<FName> SlotNames;
+	/* Default value for each slot, either compiled token value or placeholder */
+	TArray<TSharedRef<IMessageToken>> SlotDefaults;
+};
+
+/**
+ * Precompiled message shape.
+ *
+ * Token layout and slot positions are resolved once when template is compiled.
+ */
+USTRUCT(BlueprintType, Category="Utilities|MessageLog")
+struct BLUEPRINTMESSAGE_API FBlueprintMessageTemplate
+{
+	GENERATED_BODY()
+public:
+	FBlueprintMessageTemplate() = default;
+
+	/**
+	 * Compile template from category, severity and token stream.
+	 * Tokens with slot names become fillable slots.
+	 * Timestamp tokens keep their format and capture time when message is shown, other tokens are frozen at compile time.
+	 */
+	static FBlueprintMessageTemplate Compile(FName InCategory, EBlueprintMessageSeverity InSeverity, const FText& InMessage, const TArray<FBlueprintMessageToken>& InTokens);
+
+	/** Is template compiled */
+	bool IsValid() const { return Layout.IsValid(); }
+
+	/** Get slot index by name, INDEX_NONE if template has no such slot */
+	int32 FindSlot(FName Name) const;
+
+	/** Get number of unique slots */
+	int32 GetNumSlots() const { return Layout.IsValid() ? Layout->SlotNames.Num() : 0; }
+
+protected:
+	friend struct FBlueprintMessageTemplateInstance;
+	friend class UBlueprintMessageTemplateLibrary;
+
+	UPROPERTY()
+	FName Category;
+
+	UPROPERTY()
+	EBlueprintMessageSeverity Severity = EBlueprintMessageSeverity::Info;
+
+	UPROPERTY()
+	FText InitialMessage;
+
+	/* Category handle for gate lookups, see FBlueprintMessageCategoryGate */
+	int32 CategoryHandle = 0;
+
+	/* Id of blueprint node that created prototype message, 0 if unknown */
+	uint32 CallSiteId = 0;
+
+	TSharedPtr<const FBlueprintMessageTemplateLayout> Layout;
+};
+
+template<>
+struct TStructOpsTypeTraits<FBlueprintMessageTemplate> : public TStructOpsTypeTraitsBase2<FBlueprintMessageTemplate>
+{
+	enum
+	{
+		WithIdentical = false,
+	};
+};
+
+/**
+ * Runtime message built from template, holds only slot values.
+ */
+USTRUCT(BlueprintType, Category="Utilities|MessageLog")
+struct BLUEPRINTMESSAGE_API FBlueprintMessageTemplateInstance
+{
+	GENERATED_BODY()
+public:
+	FBlueprintMessageTemplateInstance() = default;
+	explicit FBlueprintMessageTemplateInstance(const FBlueprintMessageTemplate& InTemplate);
+
+	/** Set slot value by index obtained from FBlueprintMessageTemplate::FindSlot */
+	FBlueprintMessageTemplateInstance& FillSlot(int32 SlotIndex, const FBlueprintMessageToken& Token);
+	/** Set slot value by name, warns if template has no such slot */
+	FBlueprintMessageTemplateInstance& FillSlot(FName Name, const FBlueprintMessageToken& Token);
+	/** Change severity for this message */
+	FBlueprintMessageTemplateInstance& SetSeverity(EBlueprintMessageSeverity InSeverity);
+	/** Override call site id taken from template prototype */
+	FBlueprintMessageTemplateInstance& SetCallSiteId(uint32 InCallSiteId);
+
+	/** Show message in Message Log, applying category gate and repeat suppression like UBlueprintMessage::Show */
+	void Show() const;
+
+protected:
+	UPROPERTY()
+	FBlueprintMessageTemplate Template;
+
+	UPROPERTY()
+	EBlueprintMessageSeverity Severity = EBlueprintMessageSeverity::Info;
+
+	/* Id of blueprint node this message is attributed to */
+	uint32 CallSiteId = 0;
+
+	/* Filled slot values, null entries use template default */
+	TArray<TSharedPtr<IMessageToken>, TInlineAllocator<4>> SlotValues;
+	/* Tokens slots were filled with, identify message for repeat suppression without rendering */
+	TArray<FBlueprintMessageToken, TInlineAllocator<4>> SlotTokens;
+
+	/* Collect token stream for repeat suppression, static tokens are identified by instance */
+	void CollectTokens(TArray<FBlueprintMessageToken>& OutTokens) const;
+
+public:
+	/** Should we mirror message log messages from this instance to the output log? */
+	UPROPERTY(BlueprintReadWrite, Category=Message)
+	bool bSuppressLoggingToOutputLog = false;
+};
+
+/**
+ * Blueprint access to message templates.
+ */
+UCLASS()
+class BLUEPRINTMESSAGE_API UBlueprintMessageTemplateLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+public:
+
+	/**
+	 * Compile message template from a prototype message.
+	 * Named slots of prototype become template slots.
+	 *
+	 * @param Prototype message to take shape from
+	 * @returns compiled template
+	 */
+	UFUNCTION(BlueprintCallable, DisplayName="Compile Message Template", Category="Utilities|MessageLog|Template")
+	static FBlueprintMessageTemplate CompileMessageTemplate(UBlueprintMessage* Prototype);
+
+	/**
+	 * Find slot index in template to fill slot without name lookup.
+	 *
+	 * @return slot index or -1 if not found
+	 */
+	UFUNCTION(BlueprintPure, DisplayName="Find Template Slot", Category="Utilities|MessageLog|Template")
+	static int32 FindTemplateSlot(const FBlueprintMessageTemplate& Template, FName Slot);
+
+	/** Create message instance from template */
+	UFUNCTION(BlueprintPure, DisplayName="Create Message From Template", Category="Utilities|MessageLog|Template")
+	static FBlueprintMessageTemplateInstance CreateFromTemplate(const FBlueprintMessageTemplate& Template);
+
+	/** Set template slot by index */
+	UFUNCTION(BlueprintCallable, DisplayName="Fill Template Slot", Category="Utilities|MessageLog|Template", meta=(AutoCreateRefTerm="Token"))
+	static void FillTemplateSlot(UPARAM(ref) FBlueprintMessageTemplateInstance& Message, int32 SlotIndex, const FBlueprintMessageToken& Token);
+
+	/** Set template slot by name */
+	UFUNCTION(BlueprintCallable, DisplayName="Fill Template Slot By Name", Category="Utilities|MessageLog|Template", meta=(AutoCreateRefTerm="Token"))
+	static void FillTemplateSlotByName(UPARAM(ref) FBlueprintMessageTemplateInstance& Message, FName Slot, const FBlueprintMessageToken& Token);
+
+	/** Show message created from template */
+	UFUNCTION(BlueprintCallable, DisplayName="Show (Template)", Category="Utilities|MessageLog|Template")
+	static void ShowTemplateMessage(const FBlueprintMessageTemplateInstance& Message);
+};
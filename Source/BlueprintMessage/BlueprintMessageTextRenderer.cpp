@@ -0,0 +1,44 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageTextRenderer.h"
+#include "Logging/TokenizedMessage.h"
+
+void FBlueprintMessageTextRenderer::RenderTokens(const FTokenizedMessage& InMessage, FStringBuilderBase& OutBuilder)
+{
+	bool bFirst = true;
+	for (const TSharedRef<IMessageToken>& Token : InMessage.GetMessageTokens())
+	{
+		if (Token->GetType() == EMessageToken::Severity)
+		{
+			continue;
+		}
+
+		// tokens keep their text, ToString returns reference to its display string
+		const FString& TokenString = Token->ToText().ToString();
+		if (TokenString.IsEmpty())
+		{
+			continue;
+		}
+
+		if (!bFirst)
+		{
+			OutBuilder << TEXT(' ');
+		}
+		OutBuilder << TokenString;
+		bFirst = false;
+	}
+}
+
+void FBlueprintMessageTextRenderer::RenderLine(const FName& InCategory, const FTokenizedMessage& InMessage, FStringBuilderBase& OutBuilder)
+{
+	OutBuilder << InCategory << TEXT(": ");
+	RenderTokens(InMessage, OutBuilder);
+}
+
+bool FBlueprintMessageTextRenderer::HasDynamicTokens(const FTokenizedMessage& InMessage)
+{
+	return InMessage.GetMessageTokens().ContainsByPredicate([](const TSharedRef<IMessageToken>& Token)
+	{
+		return Token->GetType() == EMessageToken::DynamicText;
+	});
+}
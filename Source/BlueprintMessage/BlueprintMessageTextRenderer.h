@@ -0,0 +1,25 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FTokenizedMessage;
+
+/**
+ * Renders built messages as single lines of plain text.
+ *
+ * Tokens are walked once and appended into caller provided builder straight from text cached by each token,
+ * with an inline builder rendering does not allocate and creates no intermediate FText or FString.
+ */
+struct BLUEPRINTMESSAGE_API FBlueprintMessageTextRenderer
+{
+	/** Append message tokens separated by spaces, same text as FTokenizedMessage::ToText */
+	static void RenderTokens(const FTokenizedMessage& InMessage, FStringBuilderBase& OutBuilder);
+
+	/** Append "Category: tokens" line printed by ShowAndPrint */
+	static void RenderLine(const FName& InCategory, const FTokenizedMessage& InMessage, FStringBuilderBase& OutBuilder);
+
+	/** Does message contain tokens whose text changes over time, rendered line must not be reused for them */
+	static bool HasDynamicTokens(const FTokenizedMessage& InMessage);
+};
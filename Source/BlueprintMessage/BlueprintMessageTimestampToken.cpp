@@ -0,0 +1,116 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageTimestampToken.h"
+#include "Misc/App.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/ScopeRWLock.h"
+
+namespace BlueprintMessageTimestampToken
+{
+	/* Live timestamp tokens, engine tokens carry no type information to cast with */
+	FRWLock InstancesLock;
+	TSet<const IMessageToken*> Instances;
+}
+
+FBlueprintMessageTimestampCapture FBlueprintMessageTimestampCapture::Now()
+{
+	FBlueprintMessageTimestampCapture Result;
+	Result.Seconds = FPlatformTime::Seconds();
+	Result.UtcTicks = FDateTime::UtcNow().GetTicks();
+	Result.Timecode = FApp::GetTimecode();
+	Result.Frame = GFrameCounter;
+	return Result;
+}
+
+FBlueprintMessageTimestampToken::FBlueprintMessageTimestampToken(const FCapture& InCapture, EBlueprintMessageTimestampType InType, bool bInIncludeFrame)
+	: Capture(InCapture)
+	, Type(InType)
+	, bIncludeFrame(bInIncludeFrame)
+{
+	FWriteScopeLock Lock(BlueprintMessageTimestampToken::InstancesLock);
+	BlueprintMessageTimestampToken::Instances.Add(this);
+}
+
+FBlueprintMessageTimestampToken::~FBlueprintMessageTimestampToken()
+{
+	FWriteScopeLock Lock(BlueprintMessageTimestampToken::InstancesLock);
+	BlueprintMessageTimestampToken::Instances.Remove(this);
+}
+
+const FBlueprintMessageTimestampToken* FBlueprintMessageTimestampToken::Cast(const IMessageToken& InToken)
+{
+	if (InToken.GetType() != EMessageToken::Text)
+	{
+		return nullptr;
+	}
+	FReadScopeLock Lock(BlueprintMessageTimestampToken::InstancesLock);
+	return BlueprintMessageTimestampToken::Instances.Contains(&InToken) ? static_cast<const FBlueprintMessageTimestampToken*>(&InToken) : nullptr;
+}
+
+TSharedRef<FBlueprintMessageTimestampToken> FBlueprintMessageTimestampToken::Create(EBlueprintMessageTimestampType InType, bool bInIncludeFrame)
+{
+	return MakeShareable(new FBlueprintMessageTimestampToken(FCapture::Now(), InType, bInIncludeFrame));
+}
+
+TSharedRef<FBlueprintMessageTimestampToken> FBlueprintMessageTimestampToken::Create(const FCapture& InCapture, EBlueprintMessageTimestampType InType, bool bInIncludeFrame)
+{
+	return MakeShareable(new FBlueprintMessageTimestampToken(InCapture, InType, bInIncludeFrame));
+}
+
+const FText& FBlueprintMessageTimestampToken::ToText() const
+{
+	FScopeLock Lock(&FormatLock);
+	if (!bFormatted)
+	{
+		TStringBuilder<64> Builder;
+		Format(Capture, Type, bIncludeFrame, Builder);
+		const_cast<FBlueprintMessageTimestampToken*>(this)->CachedText = FText::FromString(FString(Builder.ToView()));
+		bFormatted = true;
+	}
+	return CachedText;
+}
+
+void FBlueprintMessageTimestampToken::Format(const FCapture& InCapture, EBlueprintMessageTimestampType InType, bool bInIncludeFrame, FStringBuilderBase& OutBuilder)
+{
+	switch (InType)
+	{
+	default:
+		checkNoEntry();
+		break;
+	case EBlueprintMessageTimestampType::SinceGStartTime:
+		{
+			const double RealTime = InCapture.Seconds - GStartTime;
+			OutBuilder.Appendf(TEXT("[%07.2f]"), RealTime);
+			break;
+		}
+	case EBlueprintMessageTimestampType::UTC:
+		{
+			FDateTime(InCapture.UtcTicks).ToString(TEXT("[%Y.%m.%d-%H.%M.%S:%s]"), OutBuilder);
+			break;
+		}
+	case EBlueprintMessageTimestampType::UTCShort:
+		{
+			FDateTime(InCapture.UtcTicks).ToString(TEXT("[%H.%M.%S:%s]"), OutBuilder);
+			break;
+		}
+	case EBlueprintMessageTimestampType::Local:
+	case EBlueprintMessageTimestampType::LocalShort:
+		{
+			// local offset is resolved at format time, it only changes with system time zone
+			const FTimespan LocalOffset = FDateTime::Now() - FDateTime::UtcNow();
+			const FDateTime LocalTime = FDateTime(InCapture.UtcTicks) + LocalOffset;
+			LocalTime.ToString(InType == EBlueprintMessageTimestampType::Local ? TEXT("[%Y.%m.%d-%H.%M.%S:%s]") : TEXT("[%H.%M.%S:%s]"), OutBuilder);
+			break;
+		}
+	case EBlueprintMessageTimestampType::Timecode:
+		{
+			OutBuilder.Appendf(TEXT("[%s]"), *InCapture.Timecode.ToString());
+			break;
+		}
+	}
+
+	if (bInIncludeFrame)
+	{
+		OutBuilder.Appendf(TEXT("[%3llu]"), InCapture.Frame % 1000);
+	}
+}
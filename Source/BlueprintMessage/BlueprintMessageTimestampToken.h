@@ -0,0 +1,59 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlueprintMessageTokenFactory.h"
+#include "Misc/Timecode.h"
+#include "Logging/TokenizedMessage.h"
+
+/**
+ * Text token capturing current time on creation and formatting it only when rendered.
+ *
+ * Creation records raw values only, so timestamps attached to messages that are never displayed cost no formatting.
+ */
+class BLUEPRINTMESSAGE_API FBlueprintMessageTimestampToken : public IMessageToken
+{
+public:
+	/* Raw time values recorded at token creation */
+	using FCapture = FBlueprintMessageTimestampCapture;
+
+	/** Create timestamp token for current time */
+	static TSharedRef<FBlueprintMessageTimestampToken> Create(EBlueprintMessageTimestampType InType, bool bInIncludeFrame);
+
+	/** Create timestamp token for previously recorded time */
+	static TSharedRef<FBlueprintMessageTimestampToken> Create(const FCapture& InCapture, EBlueprintMessageTimestampType InType, bool bInIncludeFrame);
+
+	/** Timestamp token behind engine token, nullptr if token is of other type */
+	static const FBlueprintMessageTimestampToken* Cast(const IMessageToken& InToken);
+
+	virtual ~FBlueprintMessageTimestampToken() override;
+
+	//~ Begin IMessageToken Interface
+	virtual EMessageToken::Type GetType() const override { return EMessageToken::Text; }
+	virtual const FText& ToText() const override;
+	//~ End IMessageToken Interface
+
+	/** Raw time values of this token */
+	const FCapture& GetCapture() const { return Capture; }
+
+	/** Display format of this token */
+	EBlueprintMessageTimestampType GetTimestampType() const { return Type; }
+
+	/** Is frame number appended */
+	bool IncludesFrame() const { return bIncludeFrame; }
+
+	/** Format captured time */
+	static void Format(const FCapture& InCapture, EBlueprintMessageTimestampType InType, bool bInIncludeFrame, FStringBuilderBase& OutBuilder);
+
+private:
+	FBlueprintMessageTimestampToken(const FCapture& InCapture, EBlueprintMessageTimestampType InType, bool bInIncludeFrame);
+
+	FCapture Capture;
+	EBlueprintMessageTimestampType Type;
+	bool bIncludeFrame;
+
+	/* Guards lazy formatting, token may be rendered by several sinks */
+	mutable FCriticalSection FormatLock;
+	mutable bool bFormatted = false;
+};
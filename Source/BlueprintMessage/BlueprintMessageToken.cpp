@@ -1,6 +1,10 @@
 ﻿// Copyright 2022, Aquanox.
 
 #include "BlueprintMessageToken.h"
+#include "BlueprintMessage.h"
+#include "BlueprintMessageTokenCache.h"
+#include "BlueprintMessageTokenFactory.h"
+#include "BlueprintMessageTimestampToken.h"
 #include "UObject/Package.h"
 #include "UObject/UObjectIterator.h"
 #include "Kismet/KismetSystemLibrary.h"
@@ -20,8 +24,162 @@ FBlueprintMessageToken::FBlueprintMessageToken(TSharedRef<IMessageToken>&& InTok
 {
 }
 
+namespace BlueprintMessageToken
+{
+	void InvokeDynamicDelegate(FBlueprintMessageActionDelegate InDelegate)
+	{
+		UE_LOG(LogBlueprintMessage, Verbose, TEXT("Invoke external %s"), *InDelegate.ToString<UObject>());
+
+		InDelegate.ExecuteIfBound();
+	}
+}
+
+EMessageToken::Type FBlueprintMessageToken::GetType() const
+{
+	switch (GetKind())
+	{
+	case EBlueprintMessageTokenKind::Text:
+	case EBlueprintMessageTokenKind::Name:
+	case EBlueprintMessageTokenKind::Timestamp:
+		return EMessageToken::Text;
+	case EBlueprintMessageTokenKind::URL:
+		return EMessageToken::URL;
+	case EBlueprintMessageTokenKind::AssetName:
+		return EMessageToken::AssetName;
+	case EBlueprintMessageTokenKind::Actor:
+		return EMessageToken::Actor;
+	case EBlueprintMessageTokenKind::Image:
+		return EMessageToken::Image;
+	case EBlueprintMessageTokenKind::Action:
+		return EMessageToken::Action;
+	default:
+		return Instance.IsValid() ? Instance->GetType() : static_cast<EMessageToken::Type>(-1);
+	}
+}
+
+FText FBlueprintMessageToken::ToText() const
+{
+	// mirrors text engine tokens are constructed with
+	switch (GetKind())
+	{
+	case EBlueprintMessageTokenKind::Text:
+		return Payload.Get<FBlueprintMessageTextPayload>().Text;
+	case EBlueprintMessageTokenKind::Name:
+		return FText::FromName(Payload.Get<FBlueprintMessageNamePayload>().Name);
+	case EBlueprintMessageTokenKind::URL:
+		{
+			const FBlueprintMessageUrlPayload& Url = Payload.Get<FBlueprintMessageUrlPayload>();
+			return Url.Label.IsEmpty() ? FText::FromString(Url.Url) : Url.Label;
+		}
+	case EBlueprintMessageTokenKind::AssetName:
+		{
+			const FBlueprintMessageAssetNamePayload& Asset = Payload.Get<FBlueprintMessageAssetNamePayload>();
+			return Asset.Label.IsEmpty() ? FText::FromString(Asset.AssetPath) : Asset.Label;
+		}
+	case EBlueprintMessageTokenKind::Actor:
+		{
+			const FBlueprintMessageActorPayload& Actor = Payload.Get<FBlueprintMessageActorPayload>();
+			return Actor.Label.IsEmpty() ? FText::FromString(Actor.ActorPath) : Actor.Label;
+		}
+	case EBlueprintMessageTokenKind::Image:
+		return FText::FromName(Payload.Get<FBlueprintMessageImagePayload>().ImageName);
+	case EBlueprintMessageTokenKind::Timestamp:
+		{
+			const FBlueprintMessageTimestampPayload& Timestamp = Payload.Get<FBlueprintMessageTimestampPayload>();
+			TStringBuilder<64> Builder;
+			FBlueprintMessageTimestampToken::Format(Timestamp.Capture, static_cast<EBlueprintMessageTimestampType>(Timestamp.Type), Timestamp.bIncludeFrame, Builder);
+			return FText::FromString(FString(Builder.ToView()));
+		}
+	case EBlueprintMessageTokenKind::Action:
+		return Payload.Get<FBlueprintMessageActionPayload>().Name;
+	default:
+		return Instance.IsValid() ? Instance->ToText() : FText::GetEmpty();
+	}
+}
+
+TSharedPtr<IMessageToken> FBlueprintMessageToken::GetToken() const
+{
+	return Instance.IsValid() ? Instance : Materialize(FBlueprintMessageTokenCache::Get());
+}
+
+TSharedPtr<IMessageToken> FBlueprintMessageToken::Materialize(FBlueprintMessageTokenCache* InCache) const
+{
+	switch (GetKind())
+	{
+	case EBlueprintMessageTokenKind::Text:
+		{
+			const FText& Text = Payload.Get<FBlueprintMessageTextPayload>().Text;
+			if (InCache)
+			{
+				return InCache->GetTextToken(Text);
+			}
+			return FTextToken::Create(Text);
+		}
+	case EBlueprintMessageTokenKind::Name:
+		{
+			const FName& Value = Payload.Get<FBlueprintMessageNamePayload>().Name;
+			if (InCache)
+			{
+				return InCache->GetNameToken(Value);
+			}
+			return FTextToken::Create(FText::FromName(Value));
+		}
+	case EBlueprintMessageTokenKind::URL:
+		{
+			const FBlueprintMessageUrlPayload& Url = Payload.Get<FBlueprintMessageUrlPayload>();
+			return FURLToken::Create(Url.Url, Url.Label);
+		}
+	case EBlueprintMessageTokenKind::AssetName:
+		{
+			const FBlueprintMessageAssetNamePayload& Asset = Payload.Get<FBlueprintMessageAssetNamePayload>();
+			return FAssetNameToken::Create(Asset.AssetPath, Asset.Label);
+		}
+	case EBlueprintMessageTokenKind::Actor:
+		{
+			const FBlueprintMessageActorPayload& Actor = Payload.Get<FBlueprintMessageActorPayload>();
+			return FActorToken::Create(Actor.ActorPath, Actor.Guid, Actor.Label);
+		}
+	case EBlueprintMessageTokenKind::Image:
+		{
+			const FName& ImageName = Payload.Get<FBlueprintMessageImagePayload>().ImageName;
+			if (InCache)
+			{
+				return InCache->GetImageToken(ImageName);
+			}
+			return FImageToken::Create(ImageName);
+		}
+	case EBlueprintMessageTokenKind::Timestamp:
+		{
+			const FBlueprintMessageTimestampPayload& Timestamp = Payload.Get<FBlueprintMessageTimestampPayload>();
+			return FBlueprintMessageTimestampToken::Create(Timestamp.Capture, static_cast<EBlueprintMessageTimestampType>(Timestamp.Type), Timestamp.bIncludeFrame);
+		}
+	case EBlueprintMessageTokenKind::Action:
+		{
+			const FBlueprintMessageActionPayload& Action = Payload.Get<FBlueprintMessageActionPayload>();
+			return FActionToken::Create(Action.Name, Action.Description,
+				FOnActionTokenExecuted::CreateStatic(&BlueprintMessageToken::InvokeDynamicDelegate, FBlueprintMessageActionDelegate(Action.Action)),
+				Action.bSingleUse);
+		}
+	default:
+		return Instance;
+	}
+}
+
+void FBlueprintMessageToken::SetContent(const FBlueprintMessageToken& Other)
+{
+	Instance = Other.Instance;
+	InstanceHash = Other.InstanceHash;
+	Payload = Other.Payload;
+}
+
 FBlueprintMessageToken& FBlueprintMessageToken::OnMessageTokenActivated(FOnBlueprintMessageTokenActivated&& Delegate)
 {
+	if (!Instance.IsValid())
+	{
+		// delegate needs a token of its own, inline content is not shared through cache
+		Instance = Materialize(nullptr);
+		Payload.Emplace<FEmptyVariantState>();
+	}
 	if (ensure(Instance.IsValid()))
 	{
 		Instance->OnMessageTokenActivated(Delegate);
@@ -5,13 +5,104 @@
 #include "CoreMinimal.h"
 #include "UObject/Class.h"
 #include "Logging/TokenizedMessage.h"
+#include "Misc/Timecode.h"
+#include "Misc/TVariant.h"
 #include "BlueprintMessageToken.generated.h"
 
 class IMessageToken;
+class FBlueprintMessageTokenCache;
 
 /** Delegate used when clicking a message token */
 using FOnBlueprintMessageTokenActivated = FOnMessageTokenActivated;
 
+/**
+ * Raw time values recorded for timestamp token
+ */
+struct BLUEPRINTMESSAGE_API FBlueprintMessageTimestampCapture
+{
+	/* FPlatformTime::Seconds, same clock and offset as GStartTime */
+	double Seconds = 0;
+	/* FDateTime::UtcNow ticks */
+	int64 UtcTicks = 0;
+	/* FApp::GetTimecode */
+	FTimecode Timecode;
+	/* GFrameCounter */
+	uint64 Frame = 0;
+
+	/** Record current time */
+	static FBlueprintMessageTimestampCapture Now();
+};
+
+/**
+ * Kind of token content stored inline in FBlueprintMessageToken
+ */
+enum class EBlueprintMessageTokenKind : uint8
+{
+	/* Empty slot or token backed by IMessageToken instance */
+	Instance,
+	Text,
+	Name,
+	URL,
+	AssetName,
+	Actor,
+	Image,
+	Timestamp,
+	Action,
+};
+
+/* Inline payloads of built-in token kinds, engine token is created from them when message is built */
+
+struct FBlueprintMessageTextPayload
+{
+	FText Text;
+};
+
+struct FBlueprintMessageNamePayload
+{
+	FName Name;
+};
+
+struct FBlueprintMessageUrlPayload
+{
+	FString Url;
+	FText Label;
+};
+
+struct FBlueprintMessageAssetNamePayload
+{
+	FString AssetPath;
+	FText Label;
+};
+
+struct FBlueprintMessageActorPayload
+{
+	FString ActorPath;
+	FGuid Guid;
+	FText Label;
+};
+
+struct FBlueprintMessageImagePayload
+{
+	FName ImageName;
+};
+
+struct FBlueprintMessageTimestampPayload
+{
+	FBlueprintMessageTimestampCapture Capture;
+	/* EBlueprintMessageTimestampType */
+	uint8 Type = 0;
+	bool bIncludeFrame = false;
+};
+
+struct FBlueprintMessageActionPayload
+{
+	FText Name;
+	FText Description;
+	/* FBlueprintMessageActionDelegate */
+	FScriptDelegate Action;
+	bool bSingleUse = false;
+};
+
 /**
  * Wrapper-container for generic message token to pass around in blueprint
  */
@@ -24,23 +115,70 @@ public:
 	explicit  FBlueprintMessageToken(const FName& InSlot);
 	explicit  FBlueprintMessageToken(TSharedRef<IMessageToken>&& InToken);
 
+	using FPayload = TVariant<FEmptyVariantState,
+		FBlueprintMessageTextPayload,
+		FBlueprintMessageNamePayload,
+		FBlueprintMessageUrlPayload,
+		FBlueprintMessageAssetNamePayload,
+		FBlueprintMessageActorPayload,
+		FBlueprintMessageImagePayload,
+		FBlueprintMessageTimestampPayload,
+		FBlueprintMessageActionPayload>;
+
+	/** Create token of built-in kind stored inline, without allocating engine token */
+	template <typename TPayload>
+	static FBlueprintMessageToken MakeInline(TPayload&& InPayload)
+	{
+		FBlueprintMessageToken Result;
+		Result.Payload.Set<std::decay_t<TPayload>>(Forward<TPayload>(InPayload));
+		return Result;
+	}
+
 	/* Get the type of this message token */
-	EMessageToken::Type GetType() const { return Instance.IsValid() ? Instance->GetType() : static_cast<EMessageToken::Type>(-1); }
+	EMessageToken::Type GetType() const;
+	/* Get kind of inline content */
+	EBlueprintMessageTokenKind GetKind() const { return static_cast<EBlueprintMessageTokenKind>(Payload.GetIndex()); }
+	/* Get inline content of specified kind, null if token is of other kind */
+	template <typename TPayload>
+	const TPayload* GetPayload() const { return Payload.TryGet<TPayload>(); }
+	/* Is there anything besides slot name */
+	bool HasContent() const { return Instance.IsValid() || GetKind() != EBlueprintMessageTokenKind::Instance; }
 	/* Get slot name of this token */
 	const FName& GetName() const { return Name; }
-	/** Get real token instance */
-	TSharedPtr<IMessageToken> GetToken() const { return Instance; }
+	/* Get content hash of token instance known without rendering it, 0 if unknown */
+	uint64 GetInstanceHash() const { return InstanceHash; }
+	/* Set content hash of token instance, used by factories of tokens that render lazily */
+	FBlueprintMessageToken& SetInstanceHash(uint64 InHash) { InstanceHash = InHash; return *this; }
+	/* Get text as displayed by engine token */
+	FText ToText() const;
+	/** Get real token instance, created on demand for inline content */
+	TSharedPtr<IMessageToken> GetToken() const;
 	/** Set token activation processor */
 	FBlueprintMessageToken& OnMessageTokenActivated(FOnBlueprintMessageTokenActivated&& Delegate);
 protected:
 	friend class UBlueprintMessage;
-	
+	friend class FBlueprintMessageTokenList;
+	friend struct FBlueprintMessageBuilder;
+
+	/* Take content of other token keeping own slot name */
+	void SetContent(const FBlueprintMessageToken& Other);
+
+	/* Create engine token for inline content, sharing instances through cache if provided */
+	TSharedPtr<IMessageToken> Materialize(FBlueprintMessageTokenCache* InCache) const;
+
 	/* Token name */
 	FName Name;
 	/* Token instance */
 	TSharedPtr<IMessageToken> Instance;
+	/* Content hash of token instance, 0 if unknown */
+	uint64 InstanceHash = 0;
+	/* Inline content of built-in kinds */
+	FPayload Payload;
 };
 
+static_assert(FBlueprintMessageToken::FPayload::IndexOfType<FBlueprintMessageTextPayload>() == static_cast<SIZE_T>(EBlueprintMessageTokenKind::Text));
+static_assert(FBlueprintMessageToken::FPayload::IndexOfType<FBlueprintMessageActionPayload>() == static_cast<SIZE_T>(EBlueprintMessageTokenKind::Action));
+
 template<>
 struct TStructOpsTypeTraits<FBlueprintMessageToken> : public TStructOpsTypeTraitsBase2<FBlueprintMessageToken>
 {
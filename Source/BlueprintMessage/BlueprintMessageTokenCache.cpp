@@ -0,0 +1,77 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageTokenCache.h"
+#include "Misc/ScopeLock.h"
+
+FBlueprintMessageTokenCache* FBlueprintMessageTokenCache::Instance = nullptr;
+
+FBlueprintMessageTokenCache::FBlueprintMessageTokenCache(int32 InMaxSize)
+	: MaxSize(FMath::Max(InMaxSize, 1))
+	, TextTokens(MaxSize)
+	, NameTokens(MaxSize)
+	, ImageTokens(MaxSize)
+{
+	check(Instance == nullptr);
+	Instance = this;
+}
+
+FBlueprintMessageTokenCache::~FBlueprintMessageTokenCache()
+{
+	check(Instance == this);
+	Instance = nullptr;
+}
+
+TSharedRef<IMessageToken> FBlueprintMessageTokenCache::GetTextToken(const FText& InValue)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	// texts rendering the same string may still differ in localization source, those are not shared
+	if (const TSharedRef<IMessageToken>* Existing = TextTokens.FindAndTouch(InValue.ToString()))
+	{
+		if (StaticCastSharedRef<FTextToken>(*Existing)->ToText().IdenticalTo(InValue, ETextIdenticalModeFlags::DeepCompare | ETextIdenticalModeFlags::LexicalCompareInvariants))
+		{
+			return *Existing;
+		}
+	}
+
+	TSharedRef<IMessageToken> Token = FTextToken::Create(InValue);
+	TextTokens.Add(InValue.ToString(), Token);
+	return Token;
+}
+
+TSharedRef<IMessageToken> FBlueprintMessageTokenCache::GetNameToken(const FName& InValue)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (const TSharedRef<IMessageToken>* Existing = NameTokens.FindAndTouch(InValue))
+	{
+		return *Existing;
+	}
+
+	TSharedRef<IMessageToken> Token = FTextToken::Create(FText::FromName(InValue));
+	NameTokens.Add(InValue, Token);
+	return Token;
+}
+
+TSharedRef<IMessageToken> FBlueprintMessageTokenCache::GetImageToken(const FName& InValue)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (const TSharedRef<IMessageToken>* Existing = ImageTokens.FindAndTouch(InValue))
+	{
+		return *Existing;
+	}
+
+	TSharedRef<IMessageToken> Token = FImageToken::Create(InValue);
+	ImageTokens.Add(InValue, Token);
+	return Token;
+}
+
+void FBlueprintMessageTokenCache::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	TextTokens.Empty(MaxSize);
+	NameTokens.Empty(MaxSize);
+	ImageTokens.Empty(MaxSize);
+}
@@ -0,0 +1,49 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LruCache.h"
+#include "Logging/TokenizedMessage.h"
+
+/**
+ * Bounded cache of shared immutable text, name and image tokens keyed by value.
+ *
+ * Repeated text, name and image values resolve to the same token instance when messages are built instead of a new allocation.
+ * Least recently used entries are evicted once cache is full. Safe to use from any thread.
+ *
+ * Instance is owned by the module, null if interning is disabled.
+ */
+class BLUEPRINTMESSAGE_API FBlueprintMessageTokenCache
+{
+public:
+	explicit FBlueprintMessageTokenCache(int32 InMaxSize);
+	~FBlueprintMessageTokenCache();
+
+	/** Get cache instance, null if interning is disabled */
+	static FBlueprintMessageTokenCache* Get() { return Instance; }
+
+	/** Get shared text token for text value */
+	TSharedRef<IMessageToken> GetTextToken(const FText& InValue);
+
+	/** Get shared text token for name value */
+	TSharedRef<IMessageToken> GetNameToken(const FName& InValue);
+
+	/** Get shared image token for brush name */
+	TSharedRef<IMessageToken> GetImageToken(const FName& InValue);
+
+	/** Drop all cached tokens */
+	void Reset();
+
+private:
+	static FBlueprintMessageTokenCache* Instance;
+
+	FCriticalSection Lock;
+
+	/* Maximum number of tokens of each kind */
+	int32 MaxSize;
+
+	TLruCache<FString, TSharedRef<IMessageToken>> TextTokens;
+	TLruCache<FName, TSharedRef<IMessageToken>> NameTokens;
+	TLruCache<FName, TSharedRef<IMessageToken>> ImageTokens;
+};
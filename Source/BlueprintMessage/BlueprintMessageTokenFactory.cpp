@@ -3,6 +3,8 @@
 #include "BlueprintMessageTokenFactory.h"
 #include "BlueprintMessage.h"
 #include "BlueprintMessageSettings.h"
+#include "BlueprintMessageStats.h"
+#include "BlueprintMessageFormatToken.h"
 #include "Misc/UObjectToken.h"
 #include "Misc/App.h"
 
@@ -14,13 +16,6 @@
 
 struct InternalHelper
 {
-	static void InvokeDynamicDelegate(FBlueprintMessageActionDelegate InDelegate)
-	{
-		UE_LOG(LogBlueprintMessage, Verbose, TEXT("Invoke external %s"), *InDelegate.ToString<UObject>());
-
-		InDelegate.ExecuteIfBound();
-	}
-
 	static void SpawnEditorUtilityWidget(TSoftObjectPtr<UBlueprint> WidgetBP)
 	{
 		UE_LOG(LogBlueprintMessage, Verbose, TEXT("Invoke editor utility %s"), *WidgetBP.ToString());
@@ -40,31 +35,36 @@ struct InternalHelper
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeTextToken(FText Value)
 {
-	return FBlueprintMessageToken(FTextToken::Create(Value));
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeTextToken"), STAT_BlueprintMessage_MakeTextToken, STATGROUP_BlueprintMessage);
+	return FBlueprintMessageToken::MakeInline(FBlueprintMessageTextPayload{ MoveTemp(Value) });
 }
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeStringToken(FString Value)
 {
-	return FBlueprintMessageToken(FTextToken::Create(FText::FromString(Value)));
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeStringToken"), STAT_BlueprintMessage_MakeStringToken, STATGROUP_BlueprintMessage);
+	return FBlueprintMessageToken::MakeInline(FBlueprintMessageTextPayload{ FText::FromString(MoveTemp(Value)) });
 }
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeNameToken(FName Value)
 {
-	return FBlueprintMessageToken(FTextToken::Create(FText::FromName(Value)));
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeNameToken"), STAT_BlueprintMessage_MakeNameToken, STATGROUP_BlueprintMessage);
+	return FBlueprintMessageToken::MakeInline(FBlueprintMessageNamePayload{ Value });
 }
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeUrlToken(FString Value, FText Message)
 {
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeUrlToken"), STAT_BlueprintMessage_MakeUrlToken, STATGROUP_BlueprintMessage);
 	if (Value.IsEmpty())
 	{
 		UE_LOG(LogBlueprintMessage, Warning, TEXT("URLToken was created with empty value"));
 	}
 
-	return FBlueprintMessageToken(FURLToken::Create(Value, Message));
+	return FBlueprintMessageToken::MakeInline(FBlueprintMessageUrlPayload{ MoveTemp(Value), MoveTemp(Message) });
 }
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeObjectToken(UObject* Value, FText Label)
 {
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeObjectToken"), STAT_BlueprintMessage_MakeObjectToken, STATGROUP_BlueprintMessage);
 	if (!IsValid(Value))
 	{
 		UE_LOG(LogBlueprintMessage, Warning, TEXT("ObjectToken was created with empty value"));
@@ -75,6 +75,7 @@ FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeObjectToken(UObject* V
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeAssetToken(UObject* Value, FText Label)
 {
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeAssetToken"), STAT_BlueprintMessage_MakeAssetToken, STATGROUP_BlueprintMessage);
 	if (UClass* const AsClass = Cast<UClass>(Value))
 	{
 		return MakeSoftClassPathToken(FSoftClassPath(AsClass), Label);
@@ -87,46 +88,53 @@ FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeAssetToken(UObject* Va
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeSoftAssetToken(TSoftObjectPtr<UObject> Value, FText Label)
 {
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeSoftAssetToken"), STAT_BlueprintMessage_MakeSoftAssetToken, STATGROUP_BlueprintMessage);
 	return MakeAssetPathToken(Value.ToSoftObjectPath().ToString(), Label);
 }
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeSoftClassToken(TSoftClassPtr<UObject> Value, FText Label)
 {
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeSoftClassToken"), STAT_BlueprintMessage_MakeSoftClassToken, STATGROUP_BlueprintMessage);
 	return MakeAssetPathToken(Value.ToSoftObjectPath().ToString(), Label);
 }
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeSoftClassPathToken(FSoftClassPath Value, FText Label)
 {
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeSoftClassPathToken"), STAT_BlueprintMessage_MakeSoftClassPathToken, STATGROUP_BlueprintMessage);
 	return MakeAssetPathToken(Value.ToString(), Label);
 }
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeSoftAssetPathToken(FSoftObjectPath Value, FText Label)
 {
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeSoftAssetPathToken"), STAT_BlueprintMessage_MakeSoftAssetPathToken, STATGROUP_BlueprintMessage);
 	return MakeAssetPathToken(Value.ToString(), Label);
 }
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeAssetPathToken(FString AssetPath, FText Label)
 {
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeAssetPathToken"), STAT_BlueprintMessage_MakeAssetPathToken, STATGROUP_BlueprintMessage);
 	if (AssetPath.IsEmpty())
 	{
 		UE_LOG(LogBlueprintMessage, Warning, TEXT("AssetPathToken was created with empty value"));
 	}
 
-	return FBlueprintMessageToken(FAssetNameToken::Create(AssetPath, Label));
+	return FBlueprintMessageToken::MakeInline(FBlueprintMessageAssetNamePayload{ MoveTemp(AssetPath), MoveTemp(Label) });
 }
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeImageToken(FName Value)
 {
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeImageToken"), STAT_BlueprintMessage_MakeImageToken, STATGROUP_BlueprintMessage);
 	if (Value.IsNone())
 	{
 		UE_LOG(LogBlueprintMessage, Warning, TEXT("ImageToken was created with empty value"));
 	}
 
-	return FBlueprintMessageToken(FImageToken::Create(Value));
+	return FBlueprintMessageToken::MakeInline(FBlueprintMessageImagePayload{ Value });
 }
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeActorToken(AActor* Value, FText Message)
 {
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeActorToken"), STAT_BlueprintMessage_MakeActorToken, STATGROUP_BlueprintMessage);
 	if (!::IsValid(Value))
 	{
 		UE_LOG(LogBlueprintMessage, Warning, TEXT("ActorToken was created with empty value"));
@@ -138,11 +146,12 @@ FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeActorToken(AActor* Val
 #if WITH_EDITOR
 	Guid = Value ? Value->GetActorGuid() : FGuid();
 #endif
-	return FBlueprintMessageToken(FActorToken::Create(ActorPath, Guid, Message));
+	return FBlueprintMessageToken::MakeInline(FBlueprintMessageActorPayload{ MoveTemp(ActorPath), Guid, MoveTemp(Message) });
 }
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeTutorialToken(TSoftObjectPtr<UBlueprint> Value)
 {
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeTutorialToken"), STAT_BlueprintMessage_MakeTutorialToken, STATGROUP_BlueprintMessage);
 	if (Value.IsNull())
 	{
 		UE_LOG(LogBlueprintMessage, Warning, TEXT("TutorialToken was created with empty value"));
@@ -153,6 +162,7 @@ FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeTutorialToken(TSoftObj
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeDocumentationToken(FString Value)
 {
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeDocumentationToken"), STAT_BlueprintMessage_MakeDocumentationToken, STATGROUP_BlueprintMessage);
 	if (Value.IsEmpty())
 	{
 		UE_LOG(LogBlueprintMessage, Warning, TEXT("DocumentationToken was created with empty value"));
@@ -163,11 +173,13 @@ FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeDocumentationToken(FSt
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeDynamicTextToken_Delegate(FGetMessageDynamicText Value)
 {
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeDynamicTextToken_Delegate"), STAT_BlueprintMessage_MakeDynamicTextToken_Delegate, STATGROUP_BlueprintMessage);
 	return MakeDynamicTextToken_Function(Value.GetUObject(), Value.GetFunctionName());
 }
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeDynamicTextToken_Function(UObject* Object, FName FunctionName)
 {
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeDynamicTextToken_Function"), STAT_BlueprintMessage_MakeDynamicTextToken_Function, STATGROUP_BlueprintMessage);
 	TAttribute<FText> Attribute;
 	if (IsValid(Object) && !FunctionName.IsNone())
 	{
@@ -182,20 +194,23 @@ FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeDynamicTextToken_Funct
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeActionToken(FText Name, FText Description, const FBlueprintMessageActionDelegate& Action, bool bInSingleUse)
 {
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeActionToken"), STAT_BlueprintMessage_MakeActionToken, STATGROUP_BlueprintMessage);
 	if (!Action.IsBound())
 	{
 		UE_LOG(LogBlueprintMessage, Warning, TEXT("ActionToken was created with empty value"));
 	}
 
-	return FBlueprintMessageToken(
-		FActionToken::Create(Name, Description,
-			FOnActionTokenExecuted::CreateStatic(&InternalHelper::InvokeDynamicDelegate, Action),
-			bInSingleUse)
-	);
+	FBlueprintMessageActionPayload Payload;
+	Payload.Name = MoveTemp(Name);
+	Payload.Description = MoveTemp(Description);
+	Payload.Action = Action;
+	Payload.bSingleUse = bInSingleUse;
+	return FBlueprintMessageToken::MakeInline(MoveTemp(Payload));
 }
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeEditorUtilityWidgetToken(TSoftObjectPtr<UBlueprint> Widget, FText ActionName, FText Description, bool bSingleUse)
 {
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeEditorUtilityWidgetToken"), STAT_BlueprintMessage_MakeEditorUtilityWidgetToken, STATGROUP_BlueprintMessage);
 	if (Widget.IsNull())
 	{
 		UE_LOG(LogBlueprintMessage, Warning, TEXT("EditorUtilityWidgetToken was created with empty value"));
@@ -215,49 +230,19 @@ FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeEditorUtilityWidgetTok
 
 FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeTimestampToken(EBlueprintMessageTimestampType Type, bool bIncludeFrame)
 {
-	FStringBuilderBase Format;
-	switch (Type)
-	{
-	default:
-		checkNoEntry();
-		break;
-	case EBlueprintMessageTimestampType::SinceGStartTime:
-		{
-			const double RealTime = FPlatformTime::Seconds() - GStartTime;
-			Format.Appendf(TEXT("[%07.2f]"), RealTime);
-			break;
-		}
-	case EBlueprintMessageTimestampType::UTC:
-		{
-			FDateTime::UtcNow().ToString(TEXT("[%Y.%m.%d-%H.%M.%S:%s]"), Format);
-			break;
-		}
-	case EBlueprintMessageTimestampType::UTCShort:
-		{
-			FDateTime::UtcNow().ToString(TEXT("[%H.%M.%S:%s]"), Format);
-			break;
-		}
-	case EBlueprintMessageTimestampType::Local:
-		{
-			FDateTime::Now().ToString(TEXT("[%Y.%m.%d-%H.%M.%S:%s]"), Format);
-			break;
-		}
-	case EBlueprintMessageTimestampType::LocalShort:
-		{
-			FDateTime::Now().ToString(TEXT("[%H.%M.%S:%s]"), Format);
-			break;
-		}
-	case EBlueprintMessageTimestampType::Timecode:
-		{
-			Format.Appendf(TEXT("[%s]"), *FApp::GetTimecode().ToString());
-			break;
-		}
-	}
-
-	if (bIncludeFrame)
-	{
-		Format.Appendf(TEXT("[%3llu]"), GFrameCounter % 1000);
-	}
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeTimestampToken"), STAT_BlueprintMessage_MakeTimestampToken, STATGROUP_BlueprintMessage);
+	// only raw time is captured here, text is formatted when token is rendered
+	FBlueprintMessageTimestampPayload Payload;
+	Payload.Capture = FBlueprintMessageTimestampCapture::Now();
+	Payload.Type = static_cast<uint8>(Type);
+	Payload.bIncludeFrame = bIncludeFrame;
+	return FBlueprintMessageToken::MakeInline(MoveTemp(Payload));
+}
 
-	return MakeTextToken(FText::FromString(Format.ToString()));
+FBlueprintMessageToken UBlueprintMessageTokenFactory::MakeDeferredFormatTextToken(FText InPattern, TArray<FFormatArgumentData> InArgs)
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("MakeDeferredFormatTextToken"), STAT_BlueprintMessage_MakeDeferredFormatTextToken, STATGROUP_BlueprintMessage);
+	TSharedRef<FBlueprintMessageFormatToken> Token = FBlueprintMessageFormatToken::Create(MoveTemp(InPattern), MoveTemp(InArgs));
+	const uint64 ContentHash = Token->GetContentHash();
+	return FBlueprintMessageToken(MoveTemp(Token)).SetInstanceHash(ContentHash);
 }
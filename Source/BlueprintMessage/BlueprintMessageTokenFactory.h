@@ -241,4 +241,15 @@ public:
 	UFUNCTION(BlueprintPure, Category="Utilities|MessageLog|Factory", meta=(BlueprintThreadSafe, TokenFactoryFunction))
 	static FBlueprintMessageToken MakeTimestampToken(EBlueprintMessageTimestampType Type = EBlueprintMessageTimestampType::SinceGStartTime, bool bIncludeFrame = false);
 
+	/**
+	 * Create a text token formatted from pattern and arguments when it is rendered.
+	 * Used by Add Text Token node in deferred format mode.
+	 *
+	 * @param InPattern Format pattern
+	 * @param InArgs Captured argument values
+	 * @return Token instance
+	 */
+	UFUNCTION(BlueprintPure, Category="Utilities|MessageLog|Factory", meta=(BlueprintThreadSafe, BlueprintInternalUseOnly=true))
+	static FBlueprintMessageToken MakeDeferredFormatTextToken(FText InPattern, TArray<FFormatArgumentData> InArgs);
+
 };
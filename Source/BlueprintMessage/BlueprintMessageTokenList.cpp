@@ -0,0 +1,118 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageTokenList.h"
+#include "BlueprintMessageStats.h"
+
+FBlueprintMessageTokenList::FStorage::~FStorage()
+{
+	DEC_MEMORY_STAT_BY(STAT_BlueprintMessage_TokenMemory, TrackedMemory);
+}
+
+void FBlueprintMessageTokenList::FStorage::UpdateTrackedMemory()
+{
+#if STATS
+	const SIZE_T Memory = Tokens.GetAllocatedSize() + SlotIndex.GetAllocatedSize();
+	if (Memory != TrackedMemory)
+	{
+		INC_MEMORY_STAT_BY(STAT_BlueprintMessage_TokenMemory, Memory);
+		DEC_MEMORY_STAT_BY(STAT_BlueprintMessage_TokenMemory, TrackedMemory);
+		TrackedMemory = Memory;
+	}
+#endif
+}
+
+FBlueprintMessageTokenList::FStorage& FBlueprintMessageTokenList::Mutate()
+{
+	if (!Storage.IsValid())
+	{
+		Storage = MakeShared<FStorage, ESPMode::ThreadSafe>();
+	}
+	else if (!Storage.IsUnique())
+	{
+		// other lists keep reading previous storage
+		Storage = MakeShared<FStorage, ESPMode::ThreadSafe>(*Storage);
+	}
+	return *Storage;
+}
+
+void FBlueprintMessageTokenList::IndexTokens(FStorage& InStorage, int32 InFirstIndex)
+{
+	for (int32 Index = InFirstIndex; Index < InStorage.Tokens.Num(); ++Index)
+	{
+		const FName& Name = InStorage.Tokens[Index].GetName();
+		if (!Name.IsNone())
+		{
+			InStorage.SlotIndex.FindOrAdd(Name).Add(Index);
+		}
+	}
+}
+
+void FBlueprintMessageTokenList::Add(const FBlueprintMessageToken& InToken)
+{
+	FStorage& Mutable = Mutate();
+	const int32 Index = Mutable.Tokens.Add(InToken);
+	if (!InToken.GetName().IsNone())
+	{
+		Mutable.SlotIndex.FindOrAdd(InToken.GetName()).Add(Index);
+	}
+	Mutable.UpdateTrackedMemory();
+}
+
+void FBlueprintMessageTokenList::Append(const FArray& InTokens)
+{
+	FStorage& Mutable = Mutate();
+	const int32 FirstIndex = Mutable.Tokens.Num();
+	Mutable.Tokens.Append(InTokens);
+	IndexTokens(Mutable, FirstIndex);
+	Mutable.UpdateTrackedMemory();
+}
+
+bool FBlueprintMessageTokenList::FillSlot(const FName& InName, const FBlueprintMessageToken& InToken)
+{
+	if (!FindSlot(InName))
+	{
+		return false;
+	}
+
+	// slot names do not change, index stays valid
+	FStorage& Mutable = Mutate();
+	for (const int32 Index : Mutable.SlotIndex.FindChecked(InName))
+	{
+		Mutable.Tokens[Index].SetContent(InToken);
+	}
+	Mutable.UpdateTrackedMemory();
+	return true;
+}
+
+int32 FBlueprintMessageTokenList::RemoveSlot(const FName& InName)
+{
+	// unnamed tokens are not indexed, NAME_None is handled by full scan
+	if (!InName.IsNone() && !FindSlot(InName))
+	{
+		return 0;
+	}
+	if (!Storage.IsValid())
+	{
+		return 0;
+	}
+
+	// compact the array in a single pass, remaining positions are shifted so index is rebuilt
+	FStorage& Mutable = Mutate();
+	const int32 NumRemoved = Mutable.Tokens.RemoveAll([&InName](const FBlueprintMessageToken& Item)
+	{
+		return Item.GetName() == InName;
+	});
+	if (NumRemoved > 0)
+	{
+		Mutable.SlotIndex.Reset();
+		IndexTokens(Mutable, 0);
+	}
+	Mutable.UpdateTrackedMemory();
+	return NumRemoved;
+}
+
+const FBlueprintMessageTokenList::FArray& FBlueprintMessageTokenList::GetEmpty()
+{
+	static const FArray Empty;
+	return Empty;
+}
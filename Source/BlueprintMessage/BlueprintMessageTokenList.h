@@ -0,0 +1,77 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlueprintMessageToken.h"
+
+/**
+ * Token stream shared between copies until one of them is modified.
+ *
+ * Copying a list only references the same immutable storage, first mutation of shared storage clones it.
+ * Storage also holds slot name to token positions index, kept in sync by every mutation so that
+ * shared storage is never written from lookups.
+ * Used by messages so that duplicating a message and passing its tokens around costs O(1).
+ * Same list must not be mutated from several threads at once.
+ */
+class BLUEPRINTMESSAGE_API FBlueprintMessageTokenList
+{
+public:
+	using FArray = TArray<FBlueprintMessageToken>;
+	using FSlotIndices = TArray<int32, TInlineAllocator<1>>;
+
+	FBlueprintMessageTokenList() = default;
+
+	/** Read access to tokens, never copies */
+	const FArray& Get() const { return Storage.IsValid() ? Storage->Tokens : GetEmpty(); }
+	operator const FArray&() const { return Get(); }
+
+	int32 Num() const { return Storage.IsValid() ? Storage->Tokens.Num() : 0; }
+	const FBlueprintMessageToken& operator[](int32 Index) const { return Storage->Tokens[Index]; }
+
+	/** Find positions of tokens with slot name, null if there are none */
+	const FSlotIndices* FindSlot(const FName& InName) const { return Storage.IsValid() ? Storage->SlotIndex.Find(InName) : nullptr; }
+
+	/** Append token */
+	void Add(const FBlueprintMessageToken& InToken);
+	/** Append tokens, storage shared with other lists is cloned at most once */
+	void Append(const FArray& InTokens);
+	/** Set content of all tokens with slot name keeping their names, returns false if there are none */
+	bool FillSlot(const FName& InName, const FBlueprintMessageToken& InToken);
+	/** Remove all tokens with slot name, returns number of removed tokens */
+	int32 RemoveSlot(const FName& InName);
+
+	/** Drop reference to storage */
+	void Reset() { Storage.Reset(); }
+
+	/** Is storage referenced by other lists */
+	bool IsShared() const { return Storage.IsValid() && !Storage.IsUnique(); }
+
+	/** Size of token storage and slot index, shared storage is reported by each list referencing it */
+	SIZE_T GetAllocatedSize() const { return Storage.IsValid() ? Storage->Tokens.GetAllocatedSize() + Storage->SlotIndex.GetAllocatedSize() : 0; }
+
+private:
+	struct FStorage
+	{
+		FArray Tokens;
+		TMap<FName, FSlotIndices> SlotIndex;
+		/* Size reported to token memory stat, storage is counted once however many lists share it */
+		SIZE_T TrackedMemory = 0;
+
+		FStorage() = default;
+		FStorage(const FStorage& Other) : Tokens(Other.Tokens), SlotIndex(Other.SlotIndex) { }
+		~FStorage();
+
+		/* Report size change to stats after mutation */
+		void UpdateTrackedMemory();
+	};
+
+	/* Write access to storage, clones it if it is shared with other lists */
+	FStorage& Mutate();
+
+	static void IndexTokens(FStorage& InStorage, int32 InFirstIndex);
+
+	static const FArray& GetEmpty();
+
+	TSharedPtr<FStorage, ESPMode::ThreadSafe> Storage;
+};
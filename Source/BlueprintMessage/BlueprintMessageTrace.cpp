@@ -0,0 +1,52 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageTrace.h"
+#include "Logging/TokenizedMessage.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "HAL/IConsoleManager.h"
+
+#if BLUEPRINTMESSAGE_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_DEFINE(BlueprintMessageChannel);
+
+namespace BlueprintMessageTrace
+{
+	bool bEmitBookmarks = false;
+
+	FAutoConsoleVariableRef CVarEmitBookmarks(
+		TEXT("BlueprintMessage.Trace.Bookmarks"),
+		bEmitBookmarks,
+		TEXT("Add Insights bookmark for every traced blueprint message, bookmark per message is costly during message bursts.\n")
+		TEXT("Requires Bookmark trace channel. 0 - off (default), 1 - on"),
+		ECVF_Default);
+}
+
+UE_TRACE_EVENT_BEGIN(BlueprintMessage, Message)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, CallSiteId)
+	UE_TRACE_EVENT_FIELD(uint16, TokenCount)
+	UE_TRACE_EVENT_FIELD(uint8, Severity)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Category)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Text)
+UE_TRACE_EVENT_END()
+
+void FBlueprintMessageTrace::OutputMessageImpl(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage, uint32 InCallSiteId)
+{
+	const FString Category = InCategory.ToString();
+	const FString Text = InMessage->ToText().ToString();
+
+	UE_TRACE_LOG(BlueprintMessage, Message, BlueprintMessageChannel)
+		<< Message.Cycle(FPlatformTime::Cycles64())
+		<< Message.CallSiteId(InCallSiteId)
+		<< Message.TokenCount(static_cast<uint16>(FMath::Min(InMessage->GetMessageTokens().Num(), static_cast<int32>(MAX_uint16))))
+		<< Message.Severity(static_cast<uint8>(InMessage->GetSeverity()))
+		<< Message.Category(*Category, Category.Len())
+		<< Message.Text(*Text, Text.Len());
+
+	if (BlueprintMessageTrace::bEmitBookmarks)
+	{
+		TRACE_BOOKMARK(TEXT("%s: %s"), *Category, *Text);
+	}
+}
+
+#endif
@@ -0,0 +1,56 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+
+class FTokenizedMessage;
+
+#define BLUEPRINTMESSAGE_TRACE_ENABLED (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+
+#if BLUEPRINTMESSAGE_TRACE_ENABLED
+UE_TRACE_CHANNEL_EXTERN(BlueprintMessageChannel, BLUEPRINTMESSAGE_API);
+#endif
+
+/**
+ * Emits shown messages to Unreal Insights on "BlueprintMessage" trace channel.
+ *
+ * Each message produces BlueprintMessage.Message event. With BlueprintMessage.Trace.Bookmarks=1 and Bookmark channel enabled
+ * message also adds a bookmark so it is visible in timing view next to CPU tracks.
+ *
+ * Enable with -trace=default,BlueprintMessage or "Trace.Enable BlueprintMessage".
+ */
+struct BLUEPRINTMESSAGE_API FBlueprintMessageTrace
+{
+	/** Is trace channel enabled */
+	static bool IsEnabled()
+	{
+#if BLUEPRINTMESSAGE_TRACE_ENABLED
+		return UE_TRACE_CHANNELEXPR_IS_ENABLED(BlueprintMessageChannel);
+#else
+		return false;
+#endif
+	}
+
+	/**
+	 * Emit message event if channel is enabled, channel is checked inline so disabled trace costs a single branch
+	 * @param InCategory message log category
+	 * @param InMessage built message
+	 * @param InCallSiteId identifier of node that produced the message, 0 if unknown
+	 */
+	static void OutputMessage(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage, uint32 InCallSiteId = 0)
+	{
+#if BLUEPRINTMESSAGE_TRACE_ENABLED
+		if (UE_TRACE_CHANNELEXPR_IS_ENABLED(BlueprintMessageChannel))
+		{
+			OutputMessageImpl(InCategory, InMessage, InCallSiteId);
+		}
+#endif
+	}
+
+private:
+#if BLUEPRINTMESSAGE_TRACE_ENABLED
+	static void OutputMessageImpl(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage, uint32 InCallSiteId);
+#endif
+};
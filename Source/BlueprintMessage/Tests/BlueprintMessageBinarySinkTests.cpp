@@ -0,0 +1,112 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageBinarySink.h"
+#include "BlueprintMessageBinaryReader.h"
+#include "BlueprintMessageFormatToken.h"
+#include "BlueprintMessageTimestampToken.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "Misc/UObjectToken.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlueprintMessageBinarySinkRoundTripTest, "BlueprintMessage.BinarySink.RoundTrip",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FBlueprintMessageBinarySinkRoundTripTest::RunTest(const FString& Parameters)
+{
+	const FString FilePath = FPaths::CreateTempFilename(*FPaths::ProjectIntermediateDir(), TEXT("BinarySinkTest"), TEXT(".bpmlog"));
+	const FString ObjectPath = GetTransientPackage()->GetPathName();
+	const FString ActorPath = TEXT("/Game/Maps/Test.Test:PersistentLevel.TestActor");
+	const FString Url = TEXT("https://example.com/binary-sink");
+	const FGuid ActorGuid = FGuid::NewGuid();
+	const FBlueprintMessageTimestampCapture Capture = FBlueprintMessageTimestampCapture::Now();
+
+	{
+		FBlueprintMessageBinarySink Sink(FilePath);
+		if (!TestTrue(TEXT("Sink file opened"), Sink.IsOpen()))
+		{
+			return false;
+		}
+
+		// payload strings are new in the first message and repeated in the second
+		for (int32 Index = 0; Index < 2; ++Index)
+		{
+			TSharedRef<FTokenizedMessage> Message = FTokenizedMessage::Create(EMessageSeverity::Warning, INVTEXT("Round trip"));
+			Message->AddToken(FUObjectToken::Create(GetTransientPackage(), INVTEXT("Object")));
+			Message->AddToken(FURLToken::Create(Url, INVTEXT("Link")));
+			Message->AddToken(FActorToken::Create(ActorPath, ActorGuid, INVTEXT("Actor")));
+
+			TArray<FFormatArgumentData> Arguments;
+			FFormatArgumentData& Argument = Arguments.AddDefaulted_GetRef();
+			Argument.ArgumentName = TEXT("Count");
+			Argument.ArgumentValueType = EFormatArgumentType::Int;
+			Argument.ArgumentValueInt = 3 + Index;
+			TSharedRef<FBlueprintMessageFormatToken> FormatToken = FBlueprintMessageFormatToken::Create(INVTEXT("Count {Count}"), MoveTemp(Arguments));
+			// token formatted by another sink must still be stored unformatted
+			FormatToken->ToText();
+			Message->AddToken(FormatToken);
+			Message->AddToken(FBlueprintMessageTimestampToken::Create(Capture, EBlueprintMessageTimestampType::UTC, true));
+
+			Sink.ReceiveMessage(TEXT("BinarySinkTest"), Message);
+		}
+		// sink destructor waits for pending writes
+	}
+
+	bool bSuccess = true;
+	{
+		FBlueprintMessageBinaryReader Reader;
+		if (!TestTrue(TEXT("Reader opened file"), Reader.Open(FilePath)))
+		{
+			IFileManager::Get().Delete(*FilePath);
+			return false;
+		}
+
+		int32 NumRecords = 0;
+		FBlueprintMessageBinaryRecord Record;
+		while (Reader.Next(Record))
+		{
+			++NumRecords;
+			bSuccess &= TestEqual(TEXT("Category"), Reader.GetString(Record.CategoryId), TEXT("BinarySinkTest"));
+			bSuccess &= TestEqual(TEXT("Severity"), static_cast<int32>(Record.Severity), static_cast<int32>(EMessageSeverity::Warning));
+			if (!TestEqual(TEXT("Token count"), Record.Tokens.Num(), 6))
+			{
+				bSuccess = false;
+				continue;
+			}
+
+			bSuccess &= TestEqual(TEXT("Text token"), Reader.GetTokenText(Record.Tokens[0]), TEXT("Round trip"));
+			bSuccess &= TestEqual(TEXT("Object token type"), static_cast<int32>(Record.Tokens[1].Type), static_cast<int32>(EMessageToken::Object));
+			bSuccess &= TestEqual(TEXT("Object path"), Reader.GetString(Record.Tokens[1].PayloadId), ObjectPath);
+			bSuccess &= TestEqual(TEXT("URL token type"), static_cast<int32>(Record.Tokens[2].Type), static_cast<int32>(EMessageToken::URL));
+			bSuccess &= TestEqual(TEXT("URL"), Reader.GetString(Record.Tokens[2].PayloadId), Url);
+			bSuccess &= TestEqual(TEXT("Actor token type"), static_cast<int32>(Record.Tokens[3].Type), static_cast<int32>(EMessageToken::Actor));
+			bSuccess &= TestEqual(TEXT("Actor text"), Reader.GetTokenText(Record.Tokens[3]), TEXT("Actor"));
+			bSuccess &= TestEqual(TEXT("Actor path"), Reader.GetString(Record.Tokens[3].PayloadId), ActorPath);
+			bSuccess &= TestTrue(TEXT("Actor guid"), Record.Tokens[3].ActorGuid == ActorGuid);
+			bSuccess &= TestTrue(TEXT("Format token stored unformatted"), Record.Tokens[4].DeferredType == BlueprintMessageBinaryFormat::EDeferredTokenType::FormatText);
+			bSuccess &= TestEqual(TEXT("Format pattern"), Reader.GetString(Record.Tokens[4].PatternId), TEXT("Count {Count}"));
+			bSuccess &= TestEqual(TEXT("Format text"), Reader.GetTokenText(Record.Tokens[4]), FString::Printf(TEXT("Count %d"), 3 + NumRecords - 1));
+
+			const FBlueprintMessageBinaryToken& Timestamp = Record.Tokens[5];
+			bSuccess &= TestTrue(TEXT("Timestamp stored unformatted"), Timestamp.DeferredType == BlueprintMessageBinaryFormat::EDeferredTokenType::Timestamp);
+			bSuccess &= TestEqual(TEXT("Timestamp ticks"), Timestamp.Timestamp.UtcTicks, Capture.UtcTicks);
+			bSuccess &= TestEqual(TEXT("Timestamp frame"), static_cast<int64>(Timestamp.Timestamp.Frame), static_cast<int64>(Capture.Frame));
+			TStringBuilder<64> Expected;
+			FBlueprintMessageTimestampToken::Format(Capture, EBlueprintMessageTimestampType::UTC, true, Expected);
+			bSuccess &= TestEqual(TEXT("Timestamp text"), Reader.GetTokenText(Timestamp), FString(Expected.ToView()));
+		}
+
+		bSuccess &= TestFalse(TEXT("Reader error"), Reader.HasError());
+		bSuccess &= TestEqual(TEXT("Record count"), NumRecords, 2);
+		// category, object, url and actor paths, format pattern and argument name, token text is inline
+		bSuccess &= TestEqual(TEXT("String table size"), Reader.NumStrings(), 6);
+	}
+
+	IFileManager::Get().Delete(*FilePath);
+	return bSuccess;
+}
+
+#endif
@@ -0,0 +1,45 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessageOutputSink.h"
+#include "HAL/FileManager.h"
+#include "Logging/TokenizedMessage.h"
+#include "UObject/Package.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlueprintMessageOutputSinkCostTest, "BlueprintMessage.Runtime.OutputSinkCost",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FBlueprintMessageOutputSinkCostTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumMessages = 4096;
+
+	const FString FilePath = FPaths::Combine(FPaths::ProjectIntermediateDir(), TEXT("BlueprintMessageOutputSinkCost.log"));
+	IFileManager::Get().Delete(*FilePath);
+
+	const TSharedRef<FTokenizedMessage> Tokenized = FTokenizedMessage::Create(EMessageSeverity::Warning, INVTEXT("Cost test"));
+	Tokenized->AddToken(FTextToken::Create(INVTEXT("Some text")));
+	Tokenized->AddToken(FTextToken::Create(FText::FromName(TEXT("SomeName"))));
+	Tokenized->AddToken(FUObjectToken::Create(GetTransientPackage()));
+
+	double AverageCost = 0.0;
+	{
+		FBlueprintMessageOutputSink Sink(false, FilePath);
+		for (int32 Index = 0; Index < NumMessages; ++Index)
+		{
+			Sink.ReceiveMessage(TEXT("BlueprintMessageCostTest"), Tokenized);
+		}
+		Sink.Flush();
+		AverageCost = Sink.GetAverageCostMicroseconds();
+	}
+
+	AddInfo(FString::Printf(TEXT("Output sink average cost %.2f us per message (%d messages, 3 tokens, file only)"), AverageCost, NumMessages));
+
+	const bool bWritten = TestTrue(TEXT("Sink file written"), IFileManager::Get().FileSize(*FilePath) > 0);
+	IFileManager::Get().Delete(*FilePath);
+	return bWritten && TestTrue(TEXT("Cost measured"), AverageCost > 0.0);
+}
+
+#endif
@@ -0,0 +1,51 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessage.h"
+#include "BlueprintMessagePool.h"
+#include "BlueprintMessageSettings.h"
+#include "BlueprintMessageTokenFactory.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlueprintMessagePoolReuseTest, "BlueprintMessage.Pool.ReuseAfterDestroy",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FBlueprintMessagePoolReuseTest::RunTest(const FString& Parameters)
+{
+	FBlueprintMessagePool* Pool = FBlueprintMessagePool::Get();
+	if (!TestNotNull(TEXT("Message pool"), Pool))
+	{
+		return false;
+	}
+
+	UBlueprintMessageSettings* Settings = GetMutableDefault<UBlueprintMessageSettings>();
+	TGuardValue<bool> PoolGuard(Settings->bEnableMessagePool, true);
+	TGuardValue<bool> AutoDestroyGuard(Settings->bDefaultAutoDestroy, true);
+	const FName Category(TEXT("BlueprintMessagePoolTest"));
+
+	// message destroyed by Show is not recycled, handle kept by caller stays invalid
+	UBlueprintMessage* Shown = UBlueprintMessage::CreateBlueprintMessage(Category, EBlueprintMessageSeverity::Info);
+	Shown->AddToken(UBlueprintMessageTokenFactory::MakeTextToken(INVTEXT("Shown")));
+	Shown->Show();
+	TestFalse(TEXT("Auto destroyed message is invalid"), IsValid(Shown));
+	TestNotEqual(TEXT("Auto destroyed message is not reused"), UBlueprintMessage::CreateBlueprintMessage(Category, EBlueprintMessageSeverity::Info), Shown);
+
+	UBlueprintMessage* Simple = UBlueprintMessage::CreateSimpleBlueprintMessage(Category, EBlueprintMessageSeverity::Info, INVTEXT("Simple"), true);
+	TestFalse(TEXT("Shown simple message is invalid"), IsValid(Simple));
+
+	// explicitly destroyed message is recycled, calls on stale handle are ignored until it is reused
+	UBlueprintMessage* Destroyed = UBlueprintMessage::CreateBlueprintMessage(Category, EBlueprintMessageSeverity::Info);
+	Destroyed->Destroy();
+	AddExpectedError(TEXT("after it was destroyed"), EAutomationExpectedErrorFlags::Contains, 1);
+	Destroyed->AddToken(UBlueprintMessageTokenFactory::MakeTextToken(INVTEXT("Stale")));
+
+	UBlueprintMessage* Reused = UBlueprintMessage::CreateBlueprintMessage(Category, EBlueprintMessageSeverity::Warning);
+	TestEqual(TEXT("Destroyed message is recycled"), Reused, Destroyed);
+	Reused->Destroy();
+	Pool->Trim(0);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,129 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "BlueprintMessage.h"
+#include "BlueprintMessageBuilder.h"
+#include "BlueprintMessageQueue.h"
+#include "BlueprintMessageSink.h"
+#include "BlueprintMessageTokenFactory.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Parse.h"
+#include "Tasks/Task.h"
+#include "UObject/StrongObjectPtr.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace BlueprintMessageThreadingTests
+{
+	const FName TestCategory(TEXT("BlueprintMessageStressTest"));
+
+	/* Counts delivered messages of test category and checks their order within each producing task */
+	class FOrderingSink : public IBlueprintMessageSink
+	{
+	public:
+		virtual void ReceiveMessage(const FName& InCategory, const TSharedRef<FTokenizedMessage>& InMessage) override
+		{
+			check(IsInGameThread());
+			if (InCategory != TestCategory)
+			{
+				return;
+			}
+
+			++NumReceived;
+
+			// messages carry "T=<task> S=<sequence>", objects and builders are numbered separately
+			const FString Text = InMessage->ToText().ToString();
+			int32 Task = INDEX_NONE, Sequence = INDEX_NONE;
+			if (!FParse::Value(*Text, TEXT("T="), Task) || !FParse::Value(*Text, TEXT("S="), Sequence))
+			{
+				++NumMalformed;
+				return;
+			}
+
+			const TPair<bool, int32> Key(Text.Contains(TEXT("Builder")), Task);
+			int32& Last = LastSequence.FindOrAdd(Key, INDEX_NONE);
+			if (Sequence <= Last)
+			{
+				++NumOutOfOrder;
+			}
+			Last = Sequence;
+		}
+
+		int32 NumReceived = 0;
+		int32 NumMalformed = 0;
+		int32 NumOutOfOrder = 0;
+		TMap<TPair<bool, int32>, int32> LastSequence;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlueprintMessageWorkerShowTest, "BlueprintMessage.Threading.ShowFromWorkers",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FBlueprintMessageWorkerShowTest::RunTest(const FString& Parameters)
+{
+	using namespace BlueprintMessageThreadingTests;
+
+	constexpr int32 NumTasks = 8;
+	constexpr int32 NumPerTask = 64;
+
+	FBlueprintMessageQueue* Queue = FBlueprintMessageQueue::Get();
+	if (!TestNotNull(TEXT("Message queue"), Queue))
+	{
+		return false;
+	}
+
+	TSharedRef<FOrderingSink> Sink = MakeShared<FOrderingSink>();
+	FBlueprintMessageSinks::Register(Sink);
+
+	auto MakeMarker = [](const TCHAR* Kind, int32 Task, int32 Sequence)
+	{
+		return FText::FromString(FString::Printf(TEXT("%s T=%d S=%d"), Kind, Task, Sequence));
+	};
+
+	// message objects are created on game thread, shown and destroyed by workers
+	TArray<TStrongObjectPtr<UBlueprintMessage>> Messages;
+	for (int32 Index = 0; Index < NumTasks * NumPerTask; ++Index)
+	{
+		UBlueprintMessage* Message = UBlueprintMessage::CreateBlueprintMessage(TestCategory, EBlueprintMessageSeverity::Error);
+		Message->AddToken(UBlueprintMessageTokenFactory::MakeTextToken(MakeMarker(TEXT("Object"), Index / NumPerTask, Index % NumPerTask)));
+		Messages.Emplace(Message);
+	}
+
+	TArray<UE::Tasks::FTask> Tasks;
+	for (int32 TaskIndex = 0; TaskIndex < NumTasks; ++TaskIndex)
+	{
+		Tasks.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [&Messages, &MakeMarker, TaskIndex]()
+		{
+			// odd tasks collect their messages in per-thread staging buffer and submit them as one batch
+			TOptional<FBlueprintMessageStagingScope> Staging;
+			if (TaskIndex % 2)
+			{
+				Staging.Emplace();
+			}
+
+			for (int32 Sequence = 0; Sequence < NumPerTask; ++Sequence)
+			{
+				UBlueprintMessage* Message = Messages[TaskIndex * NumPerTask + Sequence].Get();
+				Message->Show();
+				Message->Destroy();
+
+				FBlueprintMessageBuilder Builder(TestCategory, EBlueprintMessageSeverity::Error);
+				Builder.AddToken(UBlueprintMessageTokenFactory::MakeTextToken(MakeMarker(TEXT("Builder"), TaskIndex, Sequence)));
+				Builder.Show();
+			}
+		}));
+	}
+	UE::Tasks::Wait(Tasks);
+
+	// run deferred destroys and deliver queued messages
+	FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+	Queue->Flush();
+
+	FBlueprintMessageSinks::Unregister(Sink);
+
+	TestEqual(TEXT("Malformed messages"), Sink->NumMalformed, 0);
+	TestEqual(TEXT("Messages delivered out of order within task"), Sink->NumOutOfOrder, 0);
+	return TestEqual(TEXT("Delivered messages"), Sink->NumReceived, NumTasks * NumPerTask * 2);
+}
+
+#endif
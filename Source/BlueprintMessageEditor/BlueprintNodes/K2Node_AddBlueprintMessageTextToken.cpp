@@ -20,6 +20,8 @@
 #include "BlueprintActionDatabaseRegistrar.h"
 #include "BlueprintMessage.h"
 #include "BlueprintMessageTokenFactory.h"
+#include "BlueprintMessageSettings.h"
+#include "BlueprintNodes/K2Node_CreateBlueprintMessage.h"
 #include "Misc/EngineVersionComparison.h"
 
 #define LOCTEXT_NAMESPACE "K2Node_AddBlueprintMessageTextToken"
@@ -324,6 +326,13 @@ void UK2Node_AddBlueprintMessageTextToken::PostReconstructNode()
 
 void UK2Node_AddBlueprintMessageTextToken::ExpandNode(class FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph)
 {
+	// message removed by strip rules, skip format and token creation
+	if (UK2Node_CreateBlueprintMessage::IsChainNodeStripped(this))
+	{
+		UK2Node_CreateBlueprintMessage::BypassChainNode(this);
+		return;
+	}
+
 	Super::ExpandNode(CompilerContext, SourceGraph);
 
 	/**
@@ -333,6 +342,9 @@ void UK2Node_AddBlueprintMessageTextToken::ExpandNode(class FKismetCompilerConte
 
 	const UEdGraphSchema_K2* Schema = CompilerContext.GetSchema();
 
+	// Deferred mode hands pattern and arguments to token directly, formatting happens when token is rendered
+	const bool bDeferred = bDeferFormat || UBlueprintMessageSettings::Get()->bDeferTextTokenFormatting;
+
 	// Create a "Make Array" node to compile the list of arguments into an array for the Format function being called
 	UK2Node_MakeArray* MakeArrayNode = CompilerContext.SpawnIntermediateNode<UK2Node_MakeArray>(this, SourceGraph);
 	MakeArrayNode->AllocateDefaultPins();
@@ -340,9 +352,16 @@ void UK2Node_AddBlueprintMessageTextToken::ExpandNode(class FKismetCompilerConte
 
 	UEdGraphPin* ArrayOut = MakeArrayNode->GetOutputPin();
 
-	// This is the node that does all the Format work.
+	// This is the node that does all the Format work, or captures arguments in deferred mode.
 	UK2Node_CallFunction* CallFormatFunction = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
-	CallFormatFunction->SetFromFunction(UKismetTextLibrary::StaticClass()->FindFunctionByName(GET_MEMBER_NAME_CHECKED(UKismetTextLibrary, Format)));
+	if (bDeferred)
+	{
+		CallFormatFunction->SetFromFunction(UBlueprintMessageTokenFactory::StaticClass()->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(UBlueprintMessageTokenFactory, MakeDeferredFormatTextToken)));
+	}
+	else
+	{
+		CallFormatFunction->SetFromFunction(UKismetTextLibrary::StaticClass()->FindFunctionByName(GET_MEMBER_NAME_CHECKED(UKismetTextLibrary, Format)));
+	}
 	CallFormatFunction->AllocateDefaultPins();
 	CompilerContext.MessageLog.NotifyIntermediateObjectCreation(CallFormatFunction, this);
 
@@ -505,21 +524,30 @@ void UK2Node_AddBlueprintMessageTextToken::ExpandNode(class FKismetCompilerConte
 	// Move connection of "Format" pin to the call function's "InPattern" pin
 	CompilerContext.MovePinLinksToIntermediate(*GetFormatPin(), *CallFormatFunction->FindPinChecked(TEXT("InPattern")));
 
-	// Create Make Text Token node and pass result of TextToString to Make Text Token
-	UK2Node_CallFunction* CallMakeTextToken = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
-	CallMakeTextToken->SetFromFunction(UBlueprintMessageTokenFactory::StaticClass()->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(UBlueprintMessageTokenFactory, MakeTextToken)));
-	CallMakeTextToken->AllocateDefaultPins();
-	CompilerContext.MessageLog.NotifyIntermediateObjectCreation(CallMakeTextToken, this);
-
-	CallMakeTextToken->FindPinChecked(TEXT("Value"))->MakeLinkTo(CallFormatFunction->GetReturnValuePin());
+	// Deferred format function already produces token
+	UEdGraphPin* TokenPin = CallFormatFunction->GetReturnValuePin();
+	if (!bDeferred)
+	{
+		// Create Make Text Token node and pass result of TextToString to Make Text Token
+		UK2Node_CallFunction* CallMakeTextToken = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
+		CallMakeTextToken->SetFromFunction(UBlueprintMessageTokenFactory::StaticClass()->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(UBlueprintMessageTokenFactory, MakeTextToken)));
+		CallMakeTextToken->AllocateDefaultPins();
+		CompilerContext.MessageLog.NotifyIntermediateObjectCreation(CallMakeTextToken, this);
+
+		CallMakeTextToken->FindPinChecked(TEXT("Value"))->MakeLinkTo(TokenPin);
+		TokenPin = CallMakeTextToken->GetReturnValuePin();
+	}
 
 	// Create Add Token node
 	UK2Node_CallFunction* CallAddTokenNode = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
-	CallAddTokenNode->SetFromFunction(GetTargetFunction());
+	CallAddTokenNode->SetFromFunction(UBlueprintMessage::StaticClass()->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(UBlueprintMessage, AddTokenAtCallSite)));
 	CallAddTokenNode->AllocateDefaultPins();
 	CompilerContext.MessageLog.NotifyIntermediateObjectCreation(CallAddTokenNode, this);
 
-	CallAddTokenNode->FindPinChecked(TEXT("Token"))->MakeLinkTo(CallMakeTextToken->GetReturnValuePin());
+	// Stamp message with this node unless it was created by Create Message node
+	CallAddTokenNode->FindPinChecked(TEXT("CallSiteId"))->DefaultValue = LexToString(UK2Node_CreateBlueprintMessage::RegisterCallSite(CompilerContext, this));
+
+	CallAddTokenNode->FindPinChecked(TEXT("Token"))->MakeLinkTo(TokenPin);
 	CompilerContext.MovePinLinksToIntermediate(*GetSelfPin(), *CallAddTokenNode->FindPinChecked(UEdGraphSchema_K2::PN_Self));
 	CompilerContext.MovePinLinksToIntermediate(*GetSlotPin(), *CallAddTokenNode->FindPinChecked(TEXT("Slot")));
 
@@ -111,6 +111,10 @@ private:
 	UPROPERTY()
 	TArray<FName> PinNames;
 
+	/** Capture argument values and format text only when message is rendered */
+	UPROPERTY(EditAnywhere, Category=Format)
+	bool bDeferFormat = false;
+
 	UEdGraphPin* CachedExecPin = nullptr;
 
 	/** Cached input pins lookup table */
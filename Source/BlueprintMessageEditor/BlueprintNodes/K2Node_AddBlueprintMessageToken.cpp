@@ -5,10 +5,13 @@
 #include "BlueprintActionDatabaseRegistrar.h"
 #include "BlueprintMessage.h"
 #include "BlueprintMessageModule.h"
+#include "BlueprintMessageSettings.h"
 #include "BlueprintMessageToken.h"
 #include "BlueprintNodeSpawner.h"
 #include "BlueprintNodeStatics.h"
+#include "BlueprintNodes/K2Node_CreateBlueprintMessage.h"
 #include "FindInBlueprintManager.h"
+#include "K2Node_IfThenElse.h"
 #include "K2Node_Knot.h"
 #include "KismetCompiler.h"
 #include "Misc/EngineVersionComparison.h"
@@ -203,6 +206,12 @@ FText UK2Node_AddBlueprintMessageToken::GetFunctionContextString() const
 
 void UK2Node_AddBlueprintMessageToken::ExpandNode(FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph)
 {
+	if (UK2Node_CreateBlueprintMessage::IsChainNodeStripped(this))
+	{
+		UK2Node_CreateBlueprintMessage::BypassChainNode(this);
+		return;
+	}
+
 	auto LinkPins = [&](UEdGraphPin* A, UEdGraphPin* B)
 	{
 		if (A && B)
@@ -250,10 +259,13 @@ void UK2Node_AddBlueprintMessageToken::ExpandNode(FKismetCompilerContext& Compil
 
 	// spawn add token node
 	auto AddTokenNode = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
-	AddTokenNode->FunctionReference.SetExternalMember(GET_FUNCTION_NAME_CHECKED(UBlueprintMessage, AddToken), UBlueprintMessage::StaticClass());
+	AddTokenNode->FunctionReference.SetExternalMember(GET_FUNCTION_NAME_CHECKED(UBlueprintMessage, AddTokenAtCallSite), UBlueprintMessage::StaticClass());
 	AddTokenNode->AllocateDefaultPins();
 	CompilerContext.MessageLog.NotifyIntermediateObjectCreation(AddTokenNode, this);
 
+	// stamp call site
+	AddTokenNode->FindPinChecked(TEXT("CallSiteId"), EGPD_Input)->DefaultValue = LexToString(UK2Node_CreateBlueprintMessage::RegisterCallSite(CompilerContext, this));
+
 	// set self
 	bIsErrorFree &= LinkPins(KnotNode->GetOutputPin(), AddTokenNode->FindPinChecked(UEdGraphSchema_K2::PN_Self, EGPD_Input));
 	// set slot
@@ -263,8 +275,32 @@ void UK2Node_AddBlueprintMessageToken::ExpandNode(FKismetCompilerContext& Compil
 	bIsErrorFree &= LinkPins(FactoryNode->GetReturnValuePin(), AddTokenNode->FindPinChecked(TEXT("Token"), EGPD_Input));
 
 	// move execs to intermediate
-	bIsErrorFree &= MovePinLinksToIntermediate(GetExecPin(), AddTokenNode->GetExecPin());
 	bIsErrorFree &= MovePinLinksToIntermediate(GetThenPin(), AddTokenNode->GetThenPin());
+	if (UBlueprintMessageSettings::Get()->bGateMessagesAtRuntime)
+	{
+		// skip token creation for disabled message, covers messages not wrapped by Create Message gate
+		auto GateNode = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
+		GateNode->FunctionReference.SetExternalMember(GET_FUNCTION_NAME_CHECKED(UBlueprintMessage, IsEnabled), UBlueprintMessage::StaticClass());
+		GateNode->AllocateDefaultPins();
+		CompilerContext.MessageLog.NotifyIntermediateObjectCreation(GateNode, this);
+
+		auto BranchNode = CompilerContext.SpawnIntermediateNode<UK2Node_IfThenElse>(this, SourceGraph);
+		BranchNode->AllocateDefaultPins();
+		CompilerContext.MessageLog.NotifyIntermediateObjectCreation(BranchNode, this);
+
+		bIsErrorFree &= LinkPins(KnotNode->GetOutputPin(), GateNode->FindPinChecked(UEdGraphSchema_K2::PN_Self, EGPD_Input));
+		bIsErrorFree &= LinkPins(GateNode->GetReturnValuePin(), BranchNode->GetConditionPin());
+		bIsErrorFree &= MovePinLinksToIntermediate(GetExecPin(), BranchNode->GetExecPin());
+		bIsErrorFree &= LinkPins(BranchNode->GetThenPin(), AddTokenNode->GetExecPin());
+		for (UEdGraphPin* NextPin : AddTokenNode->GetThenPin()->LinkedTo)
+		{
+			bIsErrorFree &= LinkPins(BranchNode->GetElsePin(), NextPin);
+		}
+	}
+	else
+	{
+		bIsErrorFree &= MovePinLinksToIntermediate(GetExecPin(), AddTokenNode->GetExecPin());
+	}
 	// move chain to knot
 	bIsErrorFree &= MovePinLinksToIntermediate(FindPinChecked(PN_ABMT_Chain, EGPD_Output), KnotNode->GetOutputPin());
 
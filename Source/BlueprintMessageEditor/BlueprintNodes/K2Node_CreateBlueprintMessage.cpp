@@ -2,9 +2,17 @@
 
 #include "BlueprintNodes/K2Node_CreateBlueprintMessage.h"
 #include "BlueprintMessage.h"
+#include "BlueprintMessageBuilder.h"
+#include "BlueprintMessageCallSite.h"
+#include "BlueprintMessageLibrary.h"
+#include "BlueprintMessageSettings.h"
 #include "BlueprintNodeSpawner.h"
 #include "BlueprintActionDatabaseRegistrar.h"
+#include "K2Node_AssignmentStatement.h"
+#include "K2Node_IfThenElse.h"
+#include "K2Node_Knot.h"
 #include "K2Node_MakeArray.h"
+#include "K2Node_TemporaryVariable.h"
 #include "KismetCompiler.h"
 #include "ScopedTransaction.h"
 #include "ToolMenu.h"
@@ -12,6 +20,27 @@
 
 #define LOCTEXT_NAMESPACE "BlueprintMesage"
 
+namespace
+{
+	// Is pin a target of message function call that can be removed together with message
+	bool IsChainTargetPin(const UEdGraphPin* Pin)
+	{
+		const UK2Node_CallFunction* Node = Cast<UK2Node_CallFunction>(Pin->GetOwningNode());
+		const UFunction* Function = Node ? Node->GetTargetFunction() : nullptr;
+		if (!Function || Node->IsNodePure() || Pin->PinName != UEdGraphSchema_K2::PN_Self)
+		{
+			return false;
+		}
+		if (Function->HasAnyFunctionFlags(FUNC_Static) || !Function->GetOwnerClass()->IsChildOf<UBlueprintMessage>())
+		{
+			return false;
+		}
+		// severity can be raised after creation, duplicate creates another message
+		return Function->GetFName() != GET_FUNCTION_NAME_CHECKED(UBlueprintMessage, SetSeverity)
+			&& Function->GetFName() != GET_FUNCTION_NAME_CHECKED(UBlueprintMessage, Duplicate);
+	}
+}
+
 UK2Node_CreateBlueprintMessage::UK2Node_CreateBlueprintMessage()
 {
 	NumInputs = 0;
@@ -221,10 +250,362 @@ void UK2Node_CreateBlueprintMessage::ValidateNodeDuringCompilation(FCompilerResu
 #endif
 }
 
+UK2Node_CallFunction* UK2Node_CreateBlueprintMessage::FindExecChainShowNode() const
+{
+	// Message object is only needed if it escapes the exec chain.
+	// Simplest case "Create -> Show" with message only passed to Show can be served by builder.
+	UEdGraphPin* ReturnPin = FindPin(UEdGraphSchema_K2::PN_ReturnValue, EGPD_Output);
+	UEdGraphPin* ThenPin = FindPin(UEdGraphSchema_K2::PN_Then, EGPD_Output);
+	if (!ReturnPin || !ThenPin || ReturnPin->LinkedTo.Num() != 1 || ThenPin->LinkedTo.Num() != 1)
+	{
+		return nullptr;
+	}
+
+	UEdGraphPin* TargetPin = ReturnPin->LinkedTo[0];
+	UK2Node_CallFunction* ShowNode = Cast<UK2Node_CallFunction>(TargetPin->GetOwningNode());
+	if (!ShowNode || TargetPin->PinName != UEdGraphSchema_K2::PN_Self)
+	{
+		return nullptr;
+	}
+
+	UFunction* ShowFunction = UBlueprintMessage::StaticClass()->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(UBlueprintMessage, Show));
+	if (ShowNode->GetTargetFunction() != ShowFunction || ThenPin->LinkedTo[0] != ShowNode->GetExecPin())
+	{
+		return nullptr;
+	}
+
+	// Show entered from elsewhere needs message object on that path, replacing it would cut those links
+	if (ShowNode->GetExecPin()->LinkedTo.Num() != 1)
+	{
+		return nullptr;
+	}
+
+	return ShowNode;
+}
+
+bool UK2Node_CreateBlueprintMessage::IsStrippedFromGraph() const
+{
+	// only literal values are known at compile time
+	const UEdGraphPin* CategoryPin = FindPin(TEXT("LogCategory"), EGPD_Input);
+	const UEdGraphPin* SeverityPin = FindPin(TEXT("Severity"), EGPD_Input);
+	if (!CategoryPin || !SeverityPin || CategoryPin->HasAnyConnections() || SeverityPin->HasAnyConnections())
+	{
+		return false;
+	}
+
+	const int64 Severity = StaticEnum<EBlueprintMessageSeverity>()->GetValueByNameString(SeverityPin->GetDefaultAsString());
+	if (Severity == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const UBlueprintMessageSettings* Settings = UBlueprintMessageSettings::Get();
+	FName Category = *CategoryPin->GetDefaultAsString();
+	if (Category.IsNone())
+	{
+		Category = Settings->GetDefaultCategory();
+	}
+	if (!Settings->IsStrippedFromGraph(Category, static_cast<EBlueprintMessageSeverity>(Severity)))
+	{
+		return false;
+	}
+
+	TArray<UK2Node_CallFunction*> ChainNodes;
+	return CollectMessageChain(ChainNodes);
+}
+
+bool UK2Node_CreateBlueprintMessage::CollectMessageChain(TArray<UK2Node_CallFunction*>& OutNodes) const
+{
+	TArray<const UEdGraphPin*, TInlineAllocator<8>> MessagePins;
+	MessagePins.Add(FindPinChecked(UEdGraphSchema_K2::PN_ReturnValue, EGPD_Output));
+
+	for (int32 Index = 0; Index < MessagePins.Num(); ++Index)
+	{
+		for (UEdGraphPin* LinkedPin : MessagePins[Index]->LinkedTo)
+		{
+			UEdGraphNode* LinkedNode = LinkedPin->GetOwningNode();
+			if (const UK2Node_Knot* KnotNode = Cast<UK2Node_Knot>(LinkedNode))
+			{
+				MessagePins.Add(KnotNode->GetOutputPin());
+			}
+			else if (IsChainTargetPin(LinkedPin))
+			{
+				UK2Node_CallFunction* ChainNode = CastChecked<UK2Node_CallFunction>(LinkedNode);
+				if (!OutNodes.Contains(ChainNode))
+				{
+					OutNodes.Add(ChainNode);
+					if (const UEdGraphPin* NextPin = FindChainMessagePin(ChainNode))
+					{
+						MessagePins.Add(NextPin);
+					}
+				}
+			}
+			else
+			{
+				// message is stored or passed somewhere else
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+UEdGraphPin* UK2Node_CreateBlueprintMessage::FindChainMessagePin(const UK2Node_CallFunction* Node)
+{
+	for (UEdGraphPin* Pin : Node->Pins)
+	{
+		if (Pin->Direction == EGPD_Output && Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Object)
+		{
+			const UClass* PinClass = Cast<UClass>(Pin->PinType.PinSubCategoryObject.Get());
+			if (PinClass && PinClass->IsChildOf<UBlueprintMessage>())
+			{
+				return Pin;
+			}
+		}
+	}
+	return nullptr;
+}
+
+const UK2Node_CreateBlueprintMessage* UK2Node_CreateBlueprintMessage::FindMessageOrigin(const UEdGraphPin* MessagePin)
+{
+	const UEdGraphPin* Pin = MessagePin;
+	while (Pin && Pin->LinkedTo.Num() == 1)
+	{
+		const UEdGraphPin* SourcePin = Pin->LinkedTo[0];
+		UEdGraphNode* SourceNode = SourcePin->GetOwningNode();
+		if (const UK2Node_CreateBlueprintMessage* CreateNode = Cast<UK2Node_CreateBlueprintMessage>(SourceNode))
+		{
+			return SourcePin->PinName == UEdGraphSchema_K2::PN_ReturnValue ? CreateNode : nullptr;
+		}
+
+		const UK2Node_Knot* KnotNode = Cast<UK2Node_Knot>(SourceNode);
+		const UK2Node_CallFunction* ChainNode = Cast<UK2Node_CallFunction>(SourceNode);
+		if (KnotNode)
+		{
+			Pin = KnotNode->GetInputPin();
+		}
+		else if (ChainNode && FindChainMessagePin(ChainNode) == SourcePin)
+		{
+			Pin = ChainNode->FindPin(UEdGraphSchema_K2::PN_Self, EGPD_Input);
+		}
+		else
+		{
+			break;
+		}
+	}
+	return nullptr;
+}
+
+bool UK2Node_CreateBlueprintMessage::IsChainNodeStripped(const UK2Node_CallFunction* Node)
+{
+	// node without exec input was already bypassed when its message was expanded
+	const UEdGraphPin* ExecPin = Node->GetExecPin();
+	if (!ExecPin || !ExecPin->HasAnyConnections())
+	{
+		return true;
+	}
+
+	const UK2Node_CreateBlueprintMessage* Origin = FindMessageOrigin(Node->FindPin(UEdGraphSchema_K2::PN_Self, EGPD_Input));
+	return Origin && Origin->IsStrippedFromGraph();
+}
+
+void UK2Node_CreateBlueprintMessage::BypassChainNode(UK2Node_CallFunction* Node)
+{
+	auto LinkThrough = [](UEdGraphPin* InPin, UEdGraphPin* OutPin)
+	{
+		if (InPin && OutPin)
+		{
+			const TArray<UEdGraphPin*> Sources = InPin->LinkedTo;
+			const TArray<UEdGraphPin*> Targets = OutPin->LinkedTo;
+			for (UEdGraphPin* Source : Sources)
+			{
+				for (UEdGraphPin* Target : Targets)
+				{
+					Source->MakeLinkTo(Target);
+				}
+			}
+		}
+	};
+
+	LinkThrough(Node->GetExecPin(), Node->GetThenPin());
+	// keep message chain connected so nodes expanded later still find their origin
+	LinkThrough(Node->FindPin(UEdGraphSchema_K2::PN_Self, EGPD_Input), FindChainMessagePin(Node));
+
+	Node->BreakAllNodeLinks();
+}
+
+bool UK2Node_CreateBlueprintMessage::FindChainExitPin(const TArray<UK2Node_CallFunction*>& ChainNodes, UEdGraphPin*& OutExitPin) const
+{
+	TArray<UK2Node_CallFunction*, TInlineAllocator<8>> Remaining(ChainNodes);
+
+	OutExitPin = nullptr;
+	UEdGraphPin* Pin = GetThenPin();
+	while (Pin && Pin->LinkedTo.Num() == 1)
+	{
+		UEdGraphPin* TargetPin = Pin->LinkedTo[0];
+		UEdGraphNode* TargetNode = TargetPin->GetOwningNode();
+		UK2Node_CallFunction* ChainNode = Cast<UK2Node_CallFunction>(TargetNode);
+		if (TargetPin->LinkedTo.Num() != 1)
+		{
+			// entered from elsewhere, skipping it would change other paths
+			OutExitPin = TargetPin;
+			break;
+		}
+		if (const UK2Node_Knot* KnotNode = Cast<UK2Node_Knot>(TargetNode))
+		{
+			Pin = KnotNode->GetOutputPin();
+		}
+		else if (ChainNode && Remaining.Remove(ChainNode))
+		{
+			Pin = ChainNode->GetThenPin();
+		}
+		else
+		{
+			OutExitPin = TargetPin;
+			break;
+		}
+	}
+	return Remaining.IsEmpty();
+}
+
+int32 UK2Node_CreateBlueprintMessage::RegisterCallSite(FKismetCompilerContext& CompilerContext, UK2Node* Node)
+{
+	// compiled graph holds copies of nodes, id is taken from node user placed in blueprint
+	const UK2Node* SourceNode = Cast<UK2Node>(CompilerContext.MessageLog.FindSourceObject(Node));
+	if (!SourceNode)
+	{
+		SourceNode = Node;
+	}
+
+	const UBlueprint* Blueprint = FBlueprintEditorUtils::FindBlueprintForNode(SourceNode);
+	const FSoftObjectPath BlueprintPath(Blueprint ? Blueprint : CompilerContext.Blueprint);
+
+	if (FBlueprintMessageCallSiteRegistry* Registry = FBlueprintMessageCallSiteRegistry::Get())
+	{
+		return static_cast<int32>(Registry->Register(BlueprintPath, SourceNode->NodeGuid, SourceNode->GetPathName()));
+	}
+	return static_cast<int32>(FBlueprintMessageCallSiteRegistry::MakeId(BlueprintPath, SourceNode->NodeGuid));
+}
+
+void UK2Node_CreateBlueprintMessage::ExpandRuntimeGate(FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph)
+{
+	if (!UBlueprintMessageSettings::Get()->bGateMessagesAtRuntime)
+	{
+		return;
+	}
+
+	// message used outside of chain would be left unset when chain is skipped
+	TArray<UK2Node_CallFunction*> ChainNodes;
+	UEdGraphPin* ExitPin = nullptr;
+	if (!CollectMessageChain(ChainNodes) || !FindChainExitPin(ChainNodes, ExitPin))
+	{
+		return;
+	}
+
+	bool bIsErrorFree = true;
+	const UEdGraphSchema_K2* Schema = CompilerContext.GetSchema();
+
+	// linked inputs are read by both gate and message creation, they are evaluated once into temporaries before gate
+	UEdGraphPin* EntryPin = nullptr;
+	UEdGraphPin* LastThenPin = nullptr;
+	for (const TCHAR* PinName : { TEXT("LogCategory"), TEXT("Severity") })
+	{
+		UEdGraphPin* InputPin = FindPinChecked(PinName);
+		if (InputPin->LinkedTo.Num() == 0)
+		{
+			continue;
+		}
+
+		UK2Node_TemporaryVariable* TempNode = CompilerContext.SpawnInternalVariable(this, InputPin->PinType.PinCategory, InputPin->PinType.PinSubCategory, InputPin->PinType.PinSubCategoryObject.Get());
+
+		UK2Node_AssignmentStatement* AssignNode = CompilerContext.SpawnIntermediateNode<UK2Node_AssignmentStatement>(this, SourceGraph);
+		AssignNode->AllocateDefaultPins();
+		CompilerContext.MessageLog.NotifyIntermediateObjectCreation(AssignNode, this);
+
+		bIsErrorFree &= Schema->TryCreateConnection(TempNode->GetVariablePin(), AssignNode->GetVariablePin());
+		AssignNode->NotifyPinConnectionListChanged(AssignNode->GetVariablePin());
+		bIsErrorFree &= CompilerContext.MovePinLinksToIntermediate(*InputPin, *AssignNode->GetValuePin()).CanSafeConnect();
+		AssignNode->NotifyPinConnectionListChanged(AssignNode->GetValuePin());
+		bIsErrorFree &= Schema->TryCreateConnection(TempNode->GetVariablePin(), InputPin);
+
+		if (LastThenPin)
+		{
+			bIsErrorFree &= Schema->TryCreateConnection(LastThenPin, AssignNode->GetExecPin());
+		}
+		else
+		{
+			EntryPin = AssignNode->GetExecPin();
+		}
+		LastThenPin = AssignNode->GetThenPin();
+	}
+
+	UK2Node_CallFunction* GateNode = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
+	GateNode->FunctionReference.SetExternalMember(GET_FUNCTION_NAME_CHECKED(UBlueprintMessageLibrary, IsCategoryEnabled), UBlueprintMessageLibrary::StaticClass());
+	GateNode->AllocateDefaultPins();
+	CompilerContext.MessageLog.NotifyIntermediateObjectCreation(GateNode, this);
+
+	bIsErrorFree &= CompilerContext.CopyPinLinksToIntermediate(*FindPinChecked(TEXT("LogCategory")), *GateNode->FindPinChecked(TEXT("LogCategory"))).CanSafeConnect();
+	bIsErrorFree &= CompilerContext.CopyPinLinksToIntermediate(*FindPinChecked(TEXT("Severity")), *GateNode->FindPinChecked(TEXT("Severity"))).CanSafeConnect();
+
+	UK2Node_IfThenElse* BranchNode = CompilerContext.SpawnIntermediateNode<UK2Node_IfThenElse>(this, SourceGraph);
+	BranchNode->AllocateDefaultPins();
+	CompilerContext.MessageLog.NotifyIntermediateObjectCreation(BranchNode, this);
+
+	BranchNode->GetConditionPin()->MakeLinkTo(GateNode->GetReturnValuePin());
+	if (LastThenPin)
+	{
+		bIsErrorFree &= CompilerContext.MovePinLinksToIntermediate(*GetExecPin(), *EntryPin).CanSafeConnect();
+		bIsErrorFree &= Schema->TryCreateConnection(LastThenPin, BranchNode->GetExecPin());
+	}
+	else
+	{
+		bIsErrorFree &= CompilerContext.MovePinLinksToIntermediate(*GetExecPin(), *BranchNode->GetExecPin()).CanSafeConnect();
+	}
+	BranchNode->GetThenPin()->MakeLinkTo(GetExecPin());
+	if (ExitPin)
+	{
+		BranchNode->GetElsePin()->MakeLinkTo(ExitPin);
+	}
+
+	if (!bIsErrorFree)
+	{
+		CompilerContext.MessageLog.Error(*LOCTEXT("InternalConnectionError", "Internal connection error. @@").ToString(), this);
+	}
+}
+
 void UK2Node_CreateBlueprintMessage::ExpandNode(FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph)
 {
+	if (IsStrippedFromGraph())
+	{
+		// whole chain expands to nothing, isolated nodes are pruned by compiler
+		TArray<UK2Node_CallFunction*> ChainNodes;
+		CollectMessageChain(ChainNodes);
+		for (UK2Node_CallFunction* ChainNode : ChainNodes)
+		{
+			BypassChainNode(ChainNode);
+		}
+		BypassChainNode(this);
+		return;
+	}
+
+	// exec is rerouted through gate branch, expansion below moves it further as usual
+	ExpandRuntimeGate(CompilerContext, SourceGraph);
+
+	// call site is passed to whichever function below creates or shows the message
+	const FString CallSiteId = LexToString(RegisterCallSite(CompilerContext, this));
+	if (UEdGraphPin* CallSitePin = FindPin(TEXT("CallSiteId"), EGPD_Input))
+	{
+		CallSitePin->DefaultValue = CallSiteId;
+	}
+
 	TArray<UEdGraphPin*> DynamicPins = GetDynamicPins();
 
+	if (UK2Node_CallFunction* ShowNode = FindExecChainShowNode())
+	{
+		ExpandNodeToBuilder(CompilerContext, SourceGraph, ShowNode, DynamicPins, CallSiteId);
+		return;
+	}
+
 	if (!DynamicPins.Num())
 	{
 		// there are no dynamic pins present. just do regular function call
@@ -253,6 +634,7 @@ void UK2Node_CreateBlueprintMessage::ExpandNode(FKismetCompilerContext& Compiler
 	bIsErrorFree &= MovePinLinksToIntermediate(this, UEdGraphSchema_K2::PN_Execute, CreateNode, UEdGraphSchema_K2::PN_Execute);
 	bIsErrorFree &= MovePinLinksToIntermediate(this, TEXT("LogCategory"), CreateNode, TEXT("LogCategory"));
 	bIsErrorFree &= MovePinLinksToIntermediate(this, TEXT("Severity"), CreateNode, TEXT("Severity"));
+	CreateNode->FindPinChecked(TEXT("CallSiteId"))->DefaultValue = CallSiteId;
 
 	// Create a "Add Tokens" node
 	UK2Node_CallFunction* AddTokensNode = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
@@ -301,4 +683,50 @@ void UK2Node_CreateBlueprintMessage::ExpandNode(FKismetCompilerContext& Compiler
 	BreakAllNodeLinks();
 }
 
+void UK2Node_CreateBlueprintMessage::ExpandNodeToBuilder(FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph, UK2Node_CallFunction* ShowNode, const TArray<UEdGraphPin*>& DynamicPins, const FString& CallSiteId)
+{
+	bool bIsErrorFree = true;
+
+	// Create a "Show Message" node that builds message by value
+	UK2Node_CallFunction* ShowBuilderNode = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
+	ShowBuilderNode->FunctionReference.SetExternalMember(GET_FUNCTION_NAME_CHECKED(UBlueprintMessageBuilderLibrary, ShowBlueprintMessage), UBlueprintMessageBuilderLibrary::StaticClass());
+	ShowBuilderNode->AllocateDefaultPins();
+	CompilerContext.MessageLog.NotifyIntermediateObjectCreation(ShowBuilderNode, this);
+
+	bIsErrorFree &= CompilerContext.MovePinLinksToIntermediate(*GetExecPin(), *ShowBuilderNode->GetExecPin()).CanSafeConnect();
+	bIsErrorFree &= CompilerContext.MovePinLinksToIntermediate(*FindPinChecked(TEXT("LogCategory")), *ShowBuilderNode->FindPinChecked(TEXT("LogCategory"))).CanSafeConnect();
+	bIsErrorFree &= CompilerContext.MovePinLinksToIntermediate(*FindPinChecked(TEXT("Severity")), *ShowBuilderNode->FindPinChecked(TEXT("Severity"))).CanSafeConnect();
+	ShowBuilderNode->FindPinChecked(TEXT("CallSiteId"))->DefaultValue = CallSiteId;
+
+	if (DynamicPins.Num())
+	{
+		// Create a "Make Array" node
+		UK2Node_MakeArray* MakeArrayNode = CompilerContext.SpawnIntermediateNode<UK2Node_MakeArray>(this, SourceGraph);
+		MakeArrayNode->NumInputs = DynamicPins.Num();
+		MakeArrayNode->AllocateDefaultPins();
+		CompilerContext.MessageLog.NotifyIntermediateObjectCreation(MakeArrayNode, this);
+
+		UEdGraphPin* ArrayOut = MakeArrayNode->GetOutputPin();
+		ArrayOut->MakeLinkTo(ShowBuilderNode->FindPinChecked(TEXT("Tokens")));
+		MakeArrayNode->PinConnectionListChanged(ArrayOut);
+
+		for (int32 Index = 0; Index < DynamicPins.Num(); ++Index)
+		{
+			UEdGraphPin* ArrayIn = MakeArrayNode->FindPinChecked(MakeArrayNode->GetPinName(Index));
+			bIsErrorFree &= CompilerContext.MovePinLinksToIntermediate(*DynamicPins[Index], *ArrayIn).CanSafeConnect();
+		}
+	}
+
+	// Builder node takes place of the Show node in exec chain, Show node is left isolated and pruned
+	bIsErrorFree &= CompilerContext.MovePinLinksToIntermediate(*ShowNode->GetThenPin(), *ShowBuilderNode->GetThenPin()).CanSafeConnect();
+	ShowNode->BreakAllNodeLinks();
+
+	if (!bIsErrorFree)
+	{
+		CompilerContext.MessageLog.Error(*LOCTEXT("InternalConnectionError", "Internal connection error. @@").ToString(), this);
+	}
+
+	BreakAllNodeLinks();
+}
+
 #undef LOCTEXT_NAMESAPCE
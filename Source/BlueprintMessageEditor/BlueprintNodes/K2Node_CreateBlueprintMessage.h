@@ -42,7 +42,31 @@ public:
 
 	virtual void ExpandNode(FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph) override;
 
+	/** Is message removed from compiled graph by strip rules in current compilation environment */
+	bool IsStrippedFromGraph() const;
+	/** Find Create Message node that message on pin originates from, following message chain backwards */
+	static const UK2Node_CreateBlueprintMessage* FindMessageOrigin(const UEdGraphPin* MessagePin);
+	/** Is message chain node removed together with message it operates on */
+	static bool IsChainNodeStripped(const UK2Node_CallFunction* Node);
+	/** Remove message chain node from exec and message chains, leaving it isolated */
+	static void BypassChainNode(UK2Node_CallFunction* Node);
+	/** Register source node of expanded node as message call site, returns id stamped on messages */
+	static int32 RegisterCallSite(FKismetCompilerContext& CompilerContext, UK2Node* Node);
+
 protected:
+	/** Collect nodes that operate on created message, false if message is used anywhere else */
+	bool CollectMessageChain(TArray<UK2Node_CallFunction*>& OutNodes) const;
+	/** Find output pin that passes message of chain node further */
+	static UEdGraphPin* FindChainMessagePin(const UK2Node_CallFunction* Node);
+	/** Find exec pin executed after message chain, false if chain nodes do not directly follow this node */
+	bool FindChainExitPin(const TArray<UK2Node_CallFunction*>& ChainNodes, UEdGraphPin*& OutExitPin) const;
+	/** Branch over message chain on runtime category gate, linked category and severity are evaluated once for gate and creation */
+	void ExpandRuntimeGate(FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph);
+	/** Find Show node if message object never leaves the exec chain and can be replaced with value builder */
+	UK2Node_CallFunction* FindExecChainShowNode() const;
+	/** Expand to value builder call in place of message object */
+	void ExpandNodeToBuilder(FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph, UK2Node_CallFunction* ShowNode, const TArray<UEdGraphPin*>& DynamicPins, const FString& CallSiteId);
+
 	/** The number of input pins to generate for this node */
 	UPROPERTY()
 	int32 NumInputs;
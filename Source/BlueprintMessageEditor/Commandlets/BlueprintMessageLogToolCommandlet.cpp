@@ -0,0 +1,452 @@
+﻿// Copyright 2022, Aquanox.
+
+#include "Commandlets/BlueprintMessageLogToolCommandlet.h"
+#include "BlueprintMessage.h"
+#include "BlueprintMessageBinaryReader.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+namespace BlueprintMessageLogTool
+{
+	enum class EFormat : uint8
+	{
+		None,
+		JsonLines,
+		Csv,
+		Text
+	};
+
+	const TCHAR* GetSeverityName(EMessageSeverity::Type Severity)
+	{
+		static const TCHAR* Names[] = { TEXT("CriticalError"), TEXT("Error"), TEXT("PerformanceWarning"), TEXT("Warning"), TEXT("Info") };
+		return static_cast<uint32>(Severity) < UE_ARRAY_COUNT(Names) ? Names[Severity] : TEXT("Unknown");
+	}
+
+	const TCHAR* GetTokenTypeName(EMessageToken::Type Type)
+	{
+		switch (Type)
+		{
+		case EMessageToken::Action: return TEXT("Action");
+		case EMessageToken::Actor: return TEXT("Actor");
+		case EMessageToken::AssetName: return TEXT("AssetName");
+		case EMessageToken::Documentation: return TEXT("Documentation");
+		case EMessageToken::Image: return TEXT("Image");
+		case EMessageToken::Object: return TEXT("Object");
+		case EMessageToken::Severity: return TEXT("Severity");
+		case EMessageToken::Text: return TEXT("Text");
+		case EMessageToken::Tutorial: return TEXT("Tutorial");
+		case EMessageToken::URL: return TEXT("URL");
+		case EMessageToken::EdGraph: return TEXT("EdGraph");
+		case EMessageToken::DynamicText: return TEXT("DynamicText");
+		default: return TEXT("Unknown");
+		}
+	}
+
+	bool ParseDate(const FString& InValue, int64& OutTicks)
+	{
+		FDateTime Date;
+		if (FDateTime::ParseIso8601(*InValue, Date) || FDateTime::Parse(InValue, Date))
+		{
+			OutTicks = Date.GetTicks();
+			return true;
+		}
+		return false;
+	}
+
+	/* Append UTF-8 string converted to TCHAR */
+	template<typename BuilderType>
+	FStringView Convert(FUtf8StringView InView, BuilderType& Scratch)
+	{
+		Scratch.Reset();
+		const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(InView.GetData()), InView.Len());
+		Scratch.Append(Converted.Get(), Converted.Length());
+		return Scratch.ToView();
+	}
+
+	void AppendJson(FStringBuilderBase& Out, FStringView InValue)
+	{
+		Out.AppendChar(TEXT('"'));
+		for (TCHAR Char : InValue)
+		{
+			switch (Char)
+			{
+			case TEXT('"'): Out.Append(TEXT("\\\"")); break;
+			case TEXT('\\'): Out.Append(TEXT("\\\\")); break;
+			case TEXT('\n'): Out.Append(TEXT("\\n")); break;
+			case TEXT('\r'): Out.Append(TEXT("\\r")); break;
+			case TEXT('\t'): Out.Append(TEXT("\\t")); break;
+			default:
+				if (Char < 0x20)
+				{
+					Out.Appendf(TEXT("\\u%04x"), static_cast<uint32>(Char));
+				}
+				else
+				{
+					Out.AppendChar(Char);
+				}
+				break;
+			}
+		}
+		Out.AppendChar(TEXT('"'));
+	}
+
+	void AppendCsv(FStringBuilderBase& Out, FStringView InValue)
+	{
+		Out.AppendChar(TEXT('"'));
+		for (TCHAR Char : InValue)
+		{
+			if (Char == TEXT('"'))
+			{
+				Out.AppendChar(TEXT('"'));
+			}
+			Out.AppendChar(Char == TEXT('\n') || Char == TEXT('\r') ? TEXT(' ') : Char);
+		}
+		Out.AppendChar(TEXT('"'));
+	}
+
+	struct FFilter
+	{
+		TSet<FString> Categories;
+		uint32 SeverityMask = MAX_uint32;
+		uint64 TokenTypeMask = MAX_uint64;
+		int64 After = MIN_int64;
+		int64 Before = MAX_int64;
+
+		/* Category filter result by category string id, -1 if not yet resolved */
+		mutable TArray<int8> CategoryMatches;
+
+		bool Matches(const FBlueprintMessageBinaryRecord& Record, const FBlueprintMessageBinaryReader& Reader) const
+		{
+			if (Record.Ticks < After || Record.Ticks > Before)
+			{
+				return false;
+			}
+			if (!(SeverityMask & (1u << Record.Severity)))
+			{
+				return false;
+			}
+			if (Categories.Num())
+			{
+				if (!CategoryMatches.IsValidIndex(Record.CategoryId))
+				{
+					CategoryMatches.Init(-1, Reader.NumStrings());
+				}
+				int8& Match = CategoryMatches[Record.CategoryId];
+				if (Match < 0)
+				{
+					Match = Categories.Contains(Reader.GetString(Record.CategoryId)) ? 1 : 0;
+				}
+				if (!Match)
+				{
+					return false;
+				}
+			}
+			if (TokenTypeMask != MAX_uint64)
+			{
+				bool bAnyToken = false;
+				for (const FBlueprintMessageBinaryToken& Token : Record.Tokens)
+				{
+					bAnyToken |= Token.Type < 64 && (TokenTypeMask & (1ull << Token.Type)) != 0;
+				}
+				if (!bAnyToken)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	struct FSummary
+	{
+		int64 NumRecords = 0;
+		int64 NumMatched = 0;
+		int64 FirstTicks = MAX_int64;
+		int64 LastTicks = MIN_int64;
+		TMap<uint32, int64> ByCategory;
+		TMap<uint8, int64> BySeverity;
+		TMap<uint8, int64> ByTokenType;
+
+		void Add(const FBlueprintMessageBinaryRecord& Record)
+		{
+			++NumMatched;
+			FirstTicks = FMath::Min(FirstTicks, Record.Ticks);
+			LastTicks = FMath::Max(LastTicks, Record.Ticks);
+			++ByCategory.FindOrAdd(Record.CategoryId);
+			++BySeverity.FindOrAdd(static_cast<uint8>(Record.Severity));
+			for (const FBlueprintMessageBinaryToken& Token : Record.Tokens)
+			{
+				++ByTokenType.FindOrAdd(static_cast<uint8>(Token.Type));
+			}
+		}
+
+		void Print(const FBlueprintMessageBinaryReader& Reader) const
+		{
+			UE_LOG(LogBlueprintMessage, Display, TEXT("Records: %lld, matched: %lld"), NumRecords, NumMatched);
+			if (NumMatched)
+			{
+				UE_LOG(LogBlueprintMessage, Display, TEXT("Time range: %s - %s"),
+					*FDateTime(FirstTicks).ToIso8601(), *FDateTime(LastTicks).ToIso8601());
+			}
+			for (const auto& Pair : ByCategory)
+			{
+				UE_LOG(LogBlueprintMessage, Display, TEXT("Category %s: %lld"), *Reader.GetString(Pair.Key), Pair.Value);
+			}
+			for (const auto& Pair : BySeverity)
+			{
+				UE_LOG(LogBlueprintMessage, Display, TEXT("Severity %s: %lld"), GetSeverityName(static_cast<EMessageSeverity::Type>(Pair.Key)), Pair.Value);
+			}
+			for (const auto& Pair : ByTokenType)
+			{
+				UE_LOG(LogBlueprintMessage, Display, TEXT("Token %s: %lld"), GetTokenTypeName(static_cast<EMessageToken::Type>(Pair.Key)), Pair.Value);
+			}
+		}
+	};
+}
+
+UBlueprintMessageLogToolCommandlet::UBlueprintMessageLogToolCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Convert and query binary message logs");
+	HelpUsage = TEXT("BlueprintMessageLogTool -Input=<file> [-Output=<file>] [-Format=jsonl|csv|text] [-Summary] [-Category=A,B] [-Severity=Error,Warning] [-After=<date>] [-Before=<date>] [-TokenType=Object,URL]");
+}
+
+int32 UBlueprintMessageLogToolCommandlet::Main(const FString& Params)
+{
+	using namespace BlueprintMessageLogTool;
+
+	FString InputPath;
+	if (!FParse::Value(*Params, TEXT("Input="), InputPath))
+	{
+		UE_LOG(LogBlueprintMessage, Error, TEXT("Usage: %s"), *HelpUsage);
+		return 1;
+	}
+
+	FString OutputPath;
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	EFormat Format = EFormat::None;
+	FString FormatName;
+	if (FParse::Value(*Params, TEXT("Format="), FormatName))
+	{
+		if (FormatName == TEXT("jsonl") || FormatName == TEXT("json"))
+			Format = EFormat::JsonLines;
+		else if (FormatName == TEXT("csv"))
+			Format = EFormat::Csv;
+		else if (FormatName == TEXT("text") || FormatName == TEXT("txt"))
+			Format = EFormat::Text;
+		else
+		{
+			UE_LOG(LogBlueprintMessage, Error, TEXT("Unknown format %s"), *FormatName);
+			return 1;
+		}
+	}
+	else if (!OutputPath.IsEmpty())
+	{
+		const FString Extension = FPaths::GetExtension(OutputPath);
+		Format = Extension == TEXT("csv") ? EFormat::Csv : Extension == TEXT("txt") ? EFormat::Text : EFormat::JsonLines;
+	}
+
+	const bool bSummary = FParse::Param(*Params, TEXT("Summary")) || Format == EFormat::None;
+
+	FFilter Filter;
+	FString Value;
+	TArray<FString> Values;
+	if (FParse::Value(*Params, TEXT("Category="), Value, false))
+	{
+		Value.ParseIntoArray(Values, TEXT(","));
+		Filter.Categories.Append(Values);
+	}
+	if (FParse::Value(*Params, TEXT("Severity="), Value, false))
+	{
+		Filter.SeverityMask = 0;
+		Value.ParseIntoArray(Values, TEXT(","));
+		for (const FString& Name : Values)
+		{
+			for (uint32 Severity = 0; Severity <= EMessageSeverity::Info; ++Severity)
+			{
+				if (Name == GetSeverityName(static_cast<EMessageSeverity::Type>(Severity)))
+				{
+					Filter.SeverityMask |= 1u << Severity;
+				}
+			}
+		}
+	}
+	if (FParse::Value(*Params, TEXT("TokenType="), Value, false))
+	{
+		Filter.TokenTypeMask = 0;
+		Value.ParseIntoArray(Values, TEXT(","));
+		for (const FString& Name : Values)
+		{
+			for (uint32 Type = 0; Type < 64; ++Type)
+			{
+				if (Name == GetTokenTypeName(static_cast<EMessageToken::Type>(Type)))
+				{
+					Filter.TokenTypeMask |= 1ull << Type;
+				}
+			}
+		}
+	}
+	if (FParse::Value(*Params, TEXT("After="), Value) && !ParseDate(Value, Filter.After))
+	{
+		UE_LOG(LogBlueprintMessage, Error, TEXT("Invalid date %s"), *Value);
+		return 1;
+	}
+	if (FParse::Value(*Params, TEXT("Before="), Value) && !ParseDate(Value, Filter.Before))
+	{
+		UE_LOG(LogBlueprintMessage, Error, TEXT("Invalid date %s"), *Value);
+		return 1;
+	}
+
+	FBlueprintMessageBinaryReader Reader;
+	if (!Reader.Open(InputPath))
+	{
+		return 1;
+	}
+
+	TUniquePtr<FArchive> Output;
+	if (Format != EFormat::None && !OutputPath.IsEmpty())
+	{
+		Output.Reset(IFileManager::Get().CreateFileWriter(*OutputPath));
+		if (!Output.IsValid())
+		{
+			UE_LOG(LogBlueprintMessage, Error, TEXT("Failed to open output file %s"), *OutputPath);
+			return 1;
+		}
+	}
+
+	TStringBuilder<1024> Line;
+	TStringBuilder<256> Scratch;
+
+	auto EmitLine = [&Output, &Line]()
+	{
+		if (Output.IsValid())
+		{
+			Line.AppendChar(TEXT('\n'));
+			FTCHARToUTF8 Converted(Line.GetData(), Line.Len());
+			Output->Serialize(const_cast<ANSICHAR*>(Converted.Get()), Converted.Length());
+		}
+		else
+		{
+			UE_LOG(LogBlueprintMessage, Display, TEXT("%s"), *Line);
+		}
+		Line.Reset();
+	};
+
+	if (Format == EFormat::Csv)
+	{
+		Line.Append(TEXT("Time,Category,Severity,Message,Payloads"));
+		EmitLine();
+	}
+
+	FSummary Summary;
+	FBlueprintMessageBinaryRecord Record;
+	while (Reader.Next(Record))
+	{
+		++Summary.NumRecords;
+		if (!Filter.Matches(Record, Reader))
+		{
+			continue;
+		}
+		Summary.Add(Record);
+
+		const FString Time = FDateTime(Record.Ticks).ToIso8601();
+		switch (Format)
+		{
+		case EFormat::JsonLines:
+			Line.Appendf(TEXT("{\"time\":\"%s\",\"category\":"), *Time);
+			AppendJson(Line, Convert(Reader.GetStringView(Record.CategoryId), Scratch));
+			Line.Appendf(TEXT(",\"severity\":\"%s\",\"tokens\":["), GetSeverityName(Record.Severity));
+			for (int32 Index = 0; Index < Record.Tokens.Num(); ++Index)
+			{
+				const FBlueprintMessageBinaryToken& Token = Record.Tokens[Index];
+				Line.Appendf(TEXT("%s{\"type\":\"%s\",\"text\":"), Index ? TEXT(",") : TEXT(""), GetTokenTypeName(Token.Type));
+				Scratch.Reset();
+				Reader.AppendTokenText(Token, Scratch);
+				AppendJson(Line, Scratch.ToView());
+				if (Token.DeferredType == BlueprintMessageBinaryFormat::EDeferredTokenType::FormatText)
+				{
+					Line.Append(TEXT(",\"pattern\":"));
+					AppendJson(Line, Convert(Reader.GetStringView(Token.PatternId), Scratch));
+				}
+				if (Token.DeferredType == BlueprintMessageBinaryFormat::EDeferredTokenType::Timestamp)
+				{
+					Line.Appendf(TEXT(",\"utc\":\"%s\",\"frame\":%llu"), *FDateTime(Token.Timestamp.UtcTicks).ToIso8601(), Token.Timestamp.Frame);
+				}
+				if (Token.bHasPayload)
+				{
+					Line.Append(TEXT(",\"payload\":"));
+					AppendJson(Line, Convert(Reader.GetStringView(Token.PayloadId), Scratch));
+				}
+				if (Token.Type == EMessageToken::Actor)
+				{
+					Line.Appendf(TEXT(",\"guid\":\"%s\""), *Token.ActorGuid.ToString(EGuidFormats::DigitsWithHyphens));
+				}
+				Line.AppendChar(TEXT('}'));
+			}
+			Line.Append(TEXT("]}"));
+			EmitLine();
+			break;
+		case EFormat::Csv:
+		case EFormat::Text:
+		{
+			TStringBuilder<512> Message;
+			TStringBuilder<256> Payloads;
+			for (const FBlueprintMessageBinaryToken& Token : Record.Tokens)
+			{
+				if (Message.Len())
+				{
+					Message.AppendChar(TEXT(' '));
+				}
+				Reader.AppendTokenText(Token, Message);
+				if (Token.bHasPayload)
+				{
+					if (Payloads.Len())
+					{
+						Payloads.AppendChar(TEXT(';'));
+					}
+					Payloads.Append(Convert(Reader.GetStringView(Token.PayloadId), Scratch));
+				}
+			}
+
+			if (Format == EFormat::Csv)
+			{
+				Line.Append(Time).AppendChar(TEXT(','));
+				AppendCsv(Line, Convert(Reader.GetStringView(Record.CategoryId), Scratch));
+				Line.AppendChar(TEXT(',')).Append(GetSeverityName(Record.Severity)).AppendChar(TEXT(','));
+				AppendCsv(Line, Message.ToView());
+				Line.AppendChar(TEXT(','));
+				AppendCsv(Line, Payloads.ToView());
+			}
+			else
+			{
+				Line.Appendf(TEXT("[%s] %s: %s: "), *Time, *Reader.GetString(Record.CategoryId), GetSeverityName(Record.Severity));
+				Line.Append(Message.ToView());
+			}
+			EmitLine();
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	if (Output.IsValid())
+	{
+		Output->Close();
+	}
+
+	if (bSummary)
+	{
+		Summary.Print(Reader);
+	}
+
+	// reading stops at first malformed record, usually incomplete tail of a file still being written
+	UE_CLOG(Reader.HasError(), LogBlueprintMessage, Warning, TEXT("Reading stopped at offset %lld of %lld"), Reader.GetOffset(), Reader.GetSize());
+
+	return 0;
+}
@@ -0,0 +1,27 @@
+﻿// Copyright 2022, Aquanox.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BlueprintMessageLogToolCommandlet.generated.h"
+
+/**
+ * Commandlet to convert and query binary message logs written by binary message sink.
+ *
+ * Usage:
+ * -run=BlueprintMessageLogTool -Input=<file> [-Output=<file>] [-Format=jsonl|csv|text] [-Summary]
+ *     [-Category=A,B] [-Severity=Error,Warning] [-After=<date>] [-Before=<date>] [-TokenType=Object,URL]
+ *
+ * File is memory mapped and records are streamed, output is written as records are read.
+ * If output file is not specified converted records are printed to log.
+ */
+UCLASS()
+class UBlueprintMessageLogToolCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UBlueprintMessageLogToolCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};